@@ -0,0 +1,211 @@
+/* Throughput of the generators, their fill modes, jumps, seeding and a few
+   distributions, next to std::mt19937_64 and std::minstd_rand as baselines.
+   No dependencies besides the header:
+
+       g++ -std=c++17 -O2 -march=native -pthread -I. bench/bench.cpp -o xoshiro_bench
+
+   Prints one line per benchmark with ns per value (or per call) and GB/s of
+   output, the best of several repetitions. Arguments, if any, are substrings
+   of the names of the benchmarks to run. */
+#include "xoshiro.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t N_VALUES = 1 << 16;
+constexpr int REPETITIONS = 7;
+
+/* Keeps the results of the benchmarked code from being optimized away. */
+volatile std::uint64_t sink;
+
+int n_filters = 0;
+char **filters = nullptr;
+
+bool selected(const char *name)
+{
+    if (!n_filters) return true;
+    for (int ix = 0; ix < n_filters; ix++)
+        if (std::strstr(name, filters[ix])) return true;
+    return false;
+}
+
+/* Runs 'body' (which does 'n' values or calls of 'bytes_each' bytes) until
+   at least 'min_time' has passed, REPETITIONS times, and reports the best. */
+template <class Body>
+void run(const char *name, const std::size_t n, const std::size_t bytes_each, Body body)
+{
+    if (!selected(name)) return;
+    const std::chrono::duration<double> min_time(0.05);
+    double best = 1e300;
+    for (int rep = 0; rep < REPETITIONS; rep++)
+    {
+        std::size_t iterations = 0;
+        const auto start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed(0);
+        do
+        {
+            body();
+            iterations++;
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while (elapsed < min_time);
+        const double ns = 1e9 * elapsed.count() / (static_cast<double>(iterations) * n);
+        if (ns < best) best = ns;
+    }
+    if (bytes_each)
+        std::printf("%-48s %10.3f ns %10.3f GB/s\n", name, best, bytes_each / best);
+    else
+        std::printf("%-48s %10.3f ns\n", name, best);
+}
+
+/* One value per call of 'operator()'. */
+template <class rng_t>
+void bench_scalar(const char *name)
+{
+    rng_t rng(static_cast<typename rng_t::result_type>(1234567));
+    run(name, N_VALUES, sizeof(typename rng_t::result_type), [&]()
+    {
+        typename rng_t::result_type acc = 0;
+        for (std::size_t ix = 0; ix < N_VALUES; ix++)
+            acc ^= rng();
+        sink = acc;
+    });
+}
+
+/* 'fill' of a whole buffer at once. */
+template <class rng_t>
+void bench_fill(const char *name)
+{
+    using result_type = typename rng_t::result_type;
+    rng_t rng(static_cast<std::uint64_t>(1234567));
+    std::vector<result_type> out(N_VALUES);
+    run(name, N_VALUES, sizeof(result_type), [&]()
+    {
+        rng.fill(out.data(), N_VALUES);
+        sink = out[N_VALUES - 1];
+    });
+}
+
+template <class rng_t, class Distribution>
+void bench_distribution(const char *name, Distribution dist)
+{
+    rng_t rng(static_cast<typename rng_t::result_type>(1234567));
+    run(name, N_VALUES, sizeof(typename Distribution::result_type), [&]()
+    {
+        typename Distribution::result_type acc = 0;
+        for (std::size_t ix = 0; ix < N_VALUES; ix++)
+            acc += dist(rng);
+        sink = static_cast<std::uint64_t>(acc);
+    });
+}
+
+template <class rng_t>
+void bench_jumps(const char *jump_name, const char *long_jump_name, const char *discard_name)
+{
+    constexpr std::size_t calls = 256;
+    rng_t rng(static_cast<std::uint64_t>(1234567));
+    run(jump_name, calls, 0, [&]()
+    {
+        for (std::size_t ix = 0; ix < calls; ix++)
+            rng = rng.jump();
+        sink = rng.state[0];
+    });
+    run(long_jump_name, calls, 0, [&]()
+    {
+        for (std::size_t ix = 0; ix < calls; ix++)
+            rng = rng.long_jump();
+        sink = rng.state[0];
+    });
+    run(discard_name, calls, 0, [&]()
+    {
+        for (std::size_t ix = 0; ix < calls; ix++)
+            rng.discard(1000000007ull * (ix + 1));
+        sink = rng.state[0];
+    });
+}
+
+template <class rng_t>
+void bench_seeding(const char *seed_name, const char *seed_many_name)
+{
+    std::vector<std::uint64_t> keys(N_VALUES);
+    for (std::size_t ix = 0; ix < N_VALUES; ix++)
+        keys[ix] = ix;
+    rng_t rng;
+    run(seed_name, N_VALUES, 0, [&]()
+    {
+        std::uint64_t acc = 0;
+        for (std::size_t ix = 0; ix < N_VALUES; ix++)
+        {
+            rng.seed(keys[ix]);
+            acc ^= rng.state[0];
+        }
+        sink = acc;
+    });
+    std::vector<rng_t> out(N_VALUES);
+    run(seed_many_name, N_VALUES, 0, [&]()
+    {
+        Xoshiro::seed_many(keys.data(), out.data(), N_VALUES);
+        sink = out[N_VALUES - 1].state[0];
+    });
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    using namespace Xoshiro;
+    n_filters = argc - 1;
+    filters = argv + 1;
+
+    bench_scalar<Xoshiro256PP>("Xoshiro256PP::operator()");
+    bench_scalar<Xoshiro256SS>("Xoshiro256SS::operator()");
+    bench_scalar<Xoshiro512PP>("Xoshiro512PP::operator()");
+    bench_scalar<Xoroshiro128PP>("Xoroshiro128PP::operator()");
+    bench_scalar<Xoshiro128PP>("Xoshiro128PP::operator()");
+    bench_scalar<std::mt19937_64>("std::mt19937_64::operator()");
+    bench_scalar<std::minstd_rand>("std::minstd_rand::operator()");
+
+    bench_fill<Xoshiro256PP>("Xoshiro256PP::fill");
+    bench_fill<Xoshiro128PP>("Xoshiro128PP::fill");
+    bench_fill<Xoshiro256PPx4>("Xoshiro256PPx4::fill");
+    bench_fill<Xoshiro256PPx8>("Xoshiro256PPx8::fill");
+    bench_fill<Xoshiro128PPx8>("Xoshiro128PPx8::fill");
+    bench_fill<Xoshiro128PPx16>("Xoshiro128PPx16::fill");
+
+    bench_jumps<Xoshiro256PP>("Xoshiro256PP::jump", "Xoshiro256PP::long_jump", "Xoshiro256PP::discard");
+    bench_jumps<Xoshiro128PP>("Xoshiro128PP::jump", "Xoshiro128PP::long_jump", "Xoshiro128PP::discard");
+
+    bench_seeding<Xoshiro256PP>("Xoshiro256PP::seed", "seed_many<Xoshiro256PP>");
+    bench_seeding<Xoshiro128PP>("Xoshiro128PP::seed", "seed_many<Xoshiro128PP>");
+
+    bench_distribution<Xoshiro256PP>("uniform_real_distribution<double>(Xoshiro256PP)",
+                                     std::uniform_real_distribution<double>());
+    bench_distribution<std::mt19937_64>("uniform_real_distribution<double>(mt19937_64)",
+                                        std::uniform_real_distribution<double>());
+    bench_distribution<Xoshiro256PP>("uniform_int_distribution<int>(Xoshiro256PP)",
+                                     std::uniform_int_distribution<int>(0, 999));
+    bench_distribution<std::mt19937_64>("uniform_int_distribution<int>(mt19937_64)",
+                                        std::uniform_int_distribution<int>(0, 999));
+    bench_distribution<Xoshiro256PP>("normal_distribution<double>(Xoshiro256PP)",
+                                     std::normal_distribution<double>());
+    bench_distribution<std::mt19937_64>("normal_distribution<double>(mt19937_64)",
+                                        std::normal_distribution<double>());
+
+    Xoshiro256PP rng(static_cast<std::uint64_t>(1234567));
+    std::vector<double> reals(N_VALUES);
+    run("fill_uniform_real<double>(Xoshiro256PP)", N_VALUES, sizeof(double), [&]()
+    {
+        fill_uniform_real(rng, reals.data(), N_VALUES);
+        sink = static_cast<std::uint64_t>(reals[N_VALUES - 1] * 1e9);
+    });
+    run("fill_normal<double>(Xoshiro256PP)", N_VALUES, sizeof(double), [&]()
+    {
+        fill_normal(rng, reals.data(), N_VALUES, 0.0, 1.0);
+        sink = static_cast<std::uint64_t>(reals[N_VALUES - 1] * 1e9);
+    });
+    return 0;
+}
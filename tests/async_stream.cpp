@@ -0,0 +1,142 @@
+/* Checks that 'AsyncStream' hands out exactly the sequence of its engine,
+   for rings of one, two and more blocks, with values and blocks mixed and
+   through coroutines:
+
+       g++ -std=c++20 -O2 -pthread -I. tests/async_stream.cpp -o async_stream && ./async_stream
+
+   Exits with a non-zero status on the first mismatch. */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+template <std::size_t N>
+bool check_values(const std::size_t n_blocks, const std::size_t n_values)
+{
+    const Xoshiro::Xoshiro256PP rng(static_cast<std::uint64_t>(42));
+    Xoshiro::Xoshiro256PP expected = rng;
+    Xoshiro::AsyncStream<Xoshiro::Xoshiro256PP, N> stream(rng, n_blocks);
+    for (std::size_t ix = 0; ix < n_values; ix++)
+        if (stream() != expected()) return false;
+    return true;
+}
+
+template <std::size_t N>
+bool check_blocks(const std::size_t n_blocks, const std::size_t n_taken)
+{
+    const Xoshiro::Xoshiro256PP rng(static_cast<std::uint64_t>(7));
+    Xoshiro::Xoshiro256PP expected = rng;
+    Xoshiro::AsyncStream<Xoshiro::Xoshiro256PP, N> stream(rng, n_blocks, std::chrono::microseconds(1));
+    for (std::size_t block = 0; block < n_taken; block++)
+    {
+        const std::uint64_t *values;
+        while (!(values = stream.try_next_block()))
+            std::this_thread::yield();
+        for (std::size_t ix = 0; ix < N; ix++)
+            if (values[ix] != expected()) return false;
+    }
+    return true;
+}
+
+/* Values and blocks mixed: taking a block skips the rest of the block that
+   'operator()' was reading from, and never repeats or reuses its values. */
+template <std::size_t N>
+bool check_mixed(const std::size_t n_blocks)
+{
+    const Xoshiro::Xoshiro256PP rng(static_cast<std::uint64_t>(11));
+    Xoshiro::Xoshiro256PP reference = rng;
+    std::vector<std::uint64_t> expected(5*N);
+    for (std::uint64_t &value : expected)
+        value = reference();
+    Xoshiro::AsyncStream<Xoshiro::Xoshiro256PP, N> stream(rng, n_blocks);
+    bool ok = true;
+    for (std::size_t ix = 0; ix < 3; ix++)
+        ok = ok && stream() == expected[ix];
+    const std::uint64_t *values = stream.next_block();
+    for (std::size_t ix = 0; ix < N; ix++)
+        ok = ok && values[ix] == expected[N + ix];
+    for (std::size_t ix = 0; ix < N; ix++)
+        ok = ok && stream() == expected[2*N + ix];
+    while (!(values = stream.try_next_block()))
+        std::this_thread::yield();
+    for (std::size_t ix = 0; ix < N; ix++)
+        ok = ok && values[ix] == expected[3*N + ix];
+    return ok && stream() == expected[4*N];
+}
+
+#ifdef XOSHIRO_HAS_COROUTINES
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return Task(); }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+    };
+};
+
+/* Awaits blocks, then goes on one value at a time on the same stream. */
+Task consume(Xoshiro::AsyncStream<Xoshiro::Xoshiro256PP, 64> &stream, Xoshiro::Xoshiro256PP expected,
+             bool &done, bool &ok)
+{
+    for (int block = 0; block < 50; block++)
+    {
+        const std::uint64_t *values = co_await stream.next_block_async();
+        for (std::size_t ix = 0; ix < 64; ix++)
+            ok = ok && values[ix] == expected();
+    }
+    for (int ix = 0; ix < 1000; ix++)
+        ok = ok && stream() == expected();
+    done = true;
+}
+
+bool check_coroutine(const std::size_t n_blocks)
+{
+    const Xoshiro::Xoshiro256PP rng(static_cast<std::uint64_t>(3));
+    Xoshiro::AsyncStream<Xoshiro::Xoshiro256PP, 64> stream(rng, n_blocks);
+    bool done = false;
+    bool ok = true;
+    consume(stream, rng, done, ok);
+    while (!done)
+        if (!stream.resume_waiting()) std::this_thread::yield();
+    return ok;
+}
+#endif
+
+}
+
+int main()
+{
+    int failures = 0;
+    const std::size_t ring_sizes[] = { 0, 1, 2, 3, 8 };
+    for (const std::size_t n_blocks : ring_sizes)
+    {
+        if (!check_values<64>(n_blocks, 100000))
+        {
+            std::printf("operator() with %zu blocks: wrong sequence\n", n_blocks);
+            failures++;
+        }
+        if (!check_blocks<100>(n_blocks, 500))
+        {
+            std::printf("try_next_block() with %zu blocks: wrong sequence\n", n_blocks);
+            failures++;
+        }
+        if (!check_mixed<64>(n_blocks))
+        {
+            std::printf("operator() and next_block() with %zu blocks: wrong sequence\n", n_blocks);
+            failures++;
+        }
+        #ifdef XOSHIRO_HAS_COROUTINES
+        if (!check_coroutine(n_blocks))
+        {
+            std::printf("next_block_async() with %zu blocks: wrong sequence\n", n_blocks);
+            failures++;
+        }
+        #endif
+    }
+    return failures? 1 : 0;
+}
@@ -0,0 +1,73 @@
+/* Checks that 'Buffered' gives the sequence of the engine it wraps, scalar
+   or 'XoshiroLanes', through 'discard' and a save and restore in the middle
+   of a block:
+
+       g++ -std=c++17 -O2 -I. tests/buffered.cpp -o buffered && ./buffered
+
+   Exits with a non-zero status if any check fails. */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+/* 'gen_t' is what 'Buffered' wraps, with 'W' lanes (1 for a scalar engine);
+   the expected sequence is that of its 'fill'. */
+template <class gen_t, std::size_t N, std::size_t W>
+bool check(const char *name)
+{
+    using result_type = typename gen_t::result_type;
+    const gen_t gen(static_cast<std::uint64_t>(2024));
+    std::vector<result_type> expected(40*N);
+    gen_t reference = gen;
+    reference.fill(expected.data(), expected.size());
+
+    bool ok = true;
+    Xoshiro::Buffered<gen_t, N> buffered(gen);
+    std::size_t ix = 0;
+    const unsigned long long skips[] = { 0, 1, N - 3, N, 3*N + 5, 7, 10*N };
+    for (const unsigned long long skip : skips)
+    {
+        buffered.discard(skip);
+        ix += static_cast<std::size_t>(skip);
+        for (std::size_t k = 0; k < N/2 + 1; k++, ix++)
+            ok = ok && buffered() == expected[ix];
+    }
+
+    std::stringstream saved;
+    saved << buffered;
+    Xoshiro::Buffered<gen_t, N> restored;
+    saved >> restored;
+    for (std::size_t k = 0; k < 3*N; k++, ix++)
+    {
+        const result_type value = restored();
+        ok = ok && value == expected[ix] && value == buffered();
+    }
+
+    /* 'discard' of the lanes themselves, by whole rows and by a partial one */
+    gen_t discarded = gen;
+    discarded.discard(2*N + 1);
+    result_type next[2*N];
+    discarded.fill(next, 2*N);
+    const std::size_t rows_start = (2*N + 1 + W - 1) / W * W;
+    for (std::size_t k = 0; k < 2*N; k++)
+        ok = ok && next[k] == expected[rows_start + k];
+
+    if (!ok) std::printf("%s: wrong sequence\n", name);
+    return ok;
+}
+
+}
+
+int main()
+{
+    int failures = 0;
+    failures += !check<Xoshiro::Xoshiro256PP, 256, 1>("Buffered<Xoshiro256PP>");
+    failures += !check<Xoshiro::Xoshiro128PP, 64, 1>("Buffered<Xoshiro128PP, 64>");
+    failures += !check<Xoshiro::Xoshiro256PPx4, 256, 4>("Buffered<Xoshiro256PPx4>");
+    failures += !check<Xoshiro::Xoshiro256PPx8, 64, 8>("Buffered<Xoshiro256PPx8, 64>");
+    failures += !check<Xoshiro::Xoshiro128PPx16, 256, 16>("Buffered<Xoshiro128PPx16>");
+    return failures? 1 : 0;
+}
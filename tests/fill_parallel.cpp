@@ -0,0 +1,59 @@
+/* Checks that 'fill_parallel' writes the same values as the serial 'fill'
+   and leaves the generator in the same state, for lengths around the task
+   size and any number of threads, and that the tasks of 'ParallelFill' can
+   run in any order:
+
+       g++ -std=c++17 -O2 -pthread -I. tests/fill_parallel.cpp -o fill_parallel && ./fill_parallel
+
+   Exits with a non-zero status if any check fails. */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+template <class rng_t>
+bool check(const char *name)
+{
+    using result_type = typename rng_t::result_type;
+    constexpr std::size_t chunk = Xoshiro::FILL_PARALLEL_CHUNK;
+    const rng_t base(static_cast<std::uint64_t>(777));
+    bool ok = true;
+    const std::size_t lengths[] = { 0, 1, chunk - 1, chunk, chunk + 1, 3*chunk + 17 };
+    const unsigned thread_counts[] = { 1, 3, 0 };
+    for (const std::size_t n : lengths)
+    {
+        rng_t serial = base;
+        std::vector<result_type> expected(n);
+        serial.fill(expected.data(), n);
+        for (const unsigned n_threads : thread_counts)
+        {
+            rng_t parallel = base;
+            std::vector<result_type> out(n);
+            Xoshiro::fill_parallel(parallel, out.data(), n, n_threads);
+            ok = ok && out == expected && parallel == serial;
+        }
+
+        std::vector<result_type> out(n);
+        const Xoshiro::ParallelFill<rng_t> tasks(base, out.data(), n);
+        for (std::size_t task = tasks.n_tasks(); task-- > 0; )
+            tasks(task);
+        ok = ok && out == expected && tasks.end() == serial;
+    }
+    if (!ok) std::printf("fill_parallel<%s>: differs from fill\n", name);
+    return ok;
+}
+
+}
+
+int main()
+{
+    using namespace Xoshiro;
+    int failures = 0;
+    failures += !check<Xoshiro256PP>("Xoshiro256PP");
+    failures += !check<Xoshiro512PP>("Xoshiro512PP");
+    failures += !check<Xoroshiro128PP>("Xoroshiro128PP");
+    failures += !check<Xoshiro128PP>("Xoshiro128PP");
+    return failures? 1 : 0;
+}
@@ -0,0 +1,100 @@
+/* Checks the jump tables and characteristic polynomials of every engine
+   against the engines themselves:
+   - 'discard(z)' and 'jump_ahead(z)' against 'z' calls of 'operator()';
+   - each row k of the power-of-two table against x^(2^k) computed by
+     squaring x;
+   - 'jump()' and 'long_jump()' against the polynomials x^(2^a) for their
+     distances, computed the same way:
+
+       g++ -std=c++17 -O2 -I. tests/jumps.cpp -o jumps && ./jumps
+
+   Exits with a non-zero status if any check fails. */
+#include "xoshiro.h"
+
+#include <cstdio>
+
+namespace {
+
+template <class poly_t>
+bool same(const poly_t &a, const poly_t &b)
+{
+    return std::memcmp(a.coef, b.coef, sizeof(a.coef)) == 0;
+}
+
+/* x^(2^k), squaring 'poly' = x^(2^j) from j = 'j' up to 'k'. */
+template <class rng_t>
+typename rng_t::jump_polynomial_type square_up(typename rng_t::jump_polynomial_type poly, int j, const int k)
+{
+    for (; j < k; j++)
+        poly = rng_t::jump_polynomial_mul(poly, poly);
+    return poly;
+}
+
+template <class rng_t>
+bool check(const char *name, const int jump_log2, const int long_jump_log2)
+{
+    using poly_type = typename rng_t::jump_polynomial_type;
+    bool ok = true;
+    const rng_t rng(static_cast<std::uint64_t>(12345));
+
+    const unsigned long long distances[] = { 0, 1, 2, 3, 255, 256, 257, 1000, 4096, 65537, 1000003, (1ull << 21) + 12345 };
+    rng_t stepped = rng;
+    unsigned long long at = 0;
+    for (const unsigned long long z : distances)
+    {
+        for (; at < z; at++)
+            stepped();
+        rng_t discarded = rng;
+        discarded.discard(z);
+        ok = ok && discarded == stepped && rng.jump_ahead(z) == stepped;
+    }
+    if (!ok) std::printf("%s: discard or jump_ahead differs from stepping\n", name);
+
+    poly_type x = {{0}};
+    x.coef[0] = 2;
+    poly_type pow2 = x;
+    for (int k = 0; k < 64; k++)
+    {
+        if (ok && !same(rng_t::jump_polynomial(1ull << k), pow2))
+        {
+            std::printf("%s: row %d of the power-of-two table is wrong\n", name, k);
+            ok = false;
+        }
+        pow2 = rng_t::jump_polynomial_mul(pow2, pow2);
+    }
+    if (!same(rng_t::jump_polynomial(0, 1), pow2))
+    {
+        std::printf("%s: jump_polynomial(0, 1) is not x^(2^64)\n", name);
+        ok = false;
+    }
+
+    const poly_type jump_poly = square_up<rng_t>(pow2, 64, jump_log2);
+    const poly_type long_jump_poly = square_up<rng_t>(jump_poly, jump_log2, long_jump_log2);
+    if (!(rng.jump_by_polynomial(jump_poly) == rng.jump()))
+    {
+        std::printf("%s: jump() is not a jump by 2^%d\n", name, jump_log2);
+        ok = false;
+    }
+    if (!(rng.jump_by_polynomial(long_jump_poly) == rng.long_jump()))
+    {
+        std::printf("%s: long_jump() is not a jump by 2^%d\n", name, long_jump_log2);
+        ok = false;
+    }
+    return ok;
+}
+
+}
+
+int main()
+{
+    using namespace Xoshiro;
+    int failures = 0;
+    failures += !check<Xoshiro256PP>("Xoshiro256PP", 128, 192);
+    failures += !check<Xoshiro256P>("Xoshiro256P", 128, 192);
+    failures += !check<Xoshiro256SS>("Xoshiro256SS", 128, 192);
+    failures += !check<Xoshiro512PP>("Xoshiro512PP", 256, 384);
+    failures += !check<Xoroshiro128PP>("Xoroshiro128PP", 64, 96);
+    failures += !check<Xoshiro128PP>("Xoshiro128PP", 64, 96);
+    failures += !check<Xoshiro128P>("Xoshiro128P", 64, 96);
+    return failures? 1 : 0;
+}
@@ -0,0 +1,78 @@
+/* Checks that lane 'i' of 'XoshiroLanes<rng_t, W>' is the scalar engine
+   jumped 'i' times and that 'fill' interleaves the lanes, for every engine,
+   widths with and without a vector type on the target (which go through
+   different code) and lengths that are not multiples of 'W':
+
+       g++ -std=c++17 -O2 -I. tests/lanes.cpp -o lanes && ./lanes
+
+   Worth running with different '-m' or '-march' flags too. Exits with a
+   non-zero status if any check fails. */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+template <class rng_t, int W>
+bool check_width(const char *name)
+{
+    using result_type = typename rng_t::result_type;
+    const rng_t base(static_cast<std::uint64_t>(31337));
+    Xoshiro::XoshiroLanes<rng_t, W> lanes(base);
+    rng_t expected[W];
+    for (int lane = 0; lane < W; lane++)
+        expected[lane] = lane? expected[lane - 1].jump() : base;
+
+    bool ok = true;
+    const std::size_t lengths[] = { 0, 1, W - 1, W, W + 1, 1000, 4099 };
+    for (const std::size_t n : lengths)
+    {
+        std::vector<result_type> out(n + 1, 0);
+        const result_type canary = out[n] = 0x5a;
+        lanes.fill(out.data(), n);
+        /* lanes are advanced by whole rows; values past 'n' are dropped */
+        for (std::size_t row = 0; row < (n + W - 1) / W; row++)
+            for (int lane = 0; lane < W; lane++)
+            {
+                const result_type value = expected[lane]();
+                const std::size_t ix = row*W + static_cast<std::size_t>(lane);
+                ok = ok && (ix >= n || out[ix] == value);
+            }
+        ok = ok && out[n] == canary;
+        for (int lane = 0; lane < W; lane++)
+            ok = ok && lanes.lane(lane) == expected[lane];
+    }
+
+    result_type row[W];
+    lanes.next(row);
+    for (int lane = 0; lane < W; lane++)
+        ok = ok && row[lane] == expected[lane]();
+
+    if (!ok) std::printf("XoshiroLanes<%s, %d>: wrong sequence\n", name, W);
+    return ok;
+}
+
+template <class rng_t>
+int check(const char *name)
+{
+    return !check_width<rng_t, 1>(name) + !check_width<rng_t, 2>(name) + !check_width<rng_t, 3>(name)
+         + !check_width<rng_t, 4>(name) + !check_width<rng_t, 8>(name) + !check_width<rng_t, 16>(name)
+         + !check_width<rng_t, 32>(name);
+}
+
+}
+
+int main()
+{
+    using namespace Xoshiro;
+    int failures = 0;
+    failures += check<Xoshiro256PP>("Xoshiro256PP");
+    failures += check<Xoshiro256P>("Xoshiro256P");
+    failures += check<Xoshiro256SS>("Xoshiro256SS");
+    failures += check<Xoshiro512PP>("Xoshiro512PP");
+    failures += check<Xoroshiro128PP>("Xoroshiro128PP");
+    failures += check<Xoshiro128PP>("Xoshiro128PP");
+    failures += check<Xoshiro128P>("Xoshiro128P");
+    return failures? 1 : 0;
+}
@@ -0,0 +1,110 @@
+/* Checks that 'decode_wire' gives back the generators written by
+   'encode_wire', and that it rejects, reading nothing, other formats, other
+   generator types, newer versions, truncated input and more generators than
+   there is room for:
+
+       g++ -std=c++17 -O2 -I. tests/wire.cpp -o wire && ./wire
+
+   Exits with a non-zero status if any check fails. */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+/* Consecutive streams, in a plain array ('StreamArray' pads them). */
+template <class rng_t>
+std::vector<rng_t> streams(const std::size_t count)
+{
+    std::vector<rng_t> out(count, rng_t(static_cast<std::uint64_t>(5)));
+    for (std::size_t ix = 1; ix < count; ix++)
+        out[ix] = out[ix - 1].jump();
+    return out;
+}
+
+template <class rng_t>
+bool check_round_trip(const char *name)
+{
+    bool ok = true;
+    const std::size_t counts[] = { 0, 1, 5 };
+    for (const std::size_t count : counts)
+    {
+        const std::vector<rng_t> rngs = streams<rng_t>(count);
+        std::vector<unsigned char> bytes(Xoshiro::wire_size<rng_t>(count));
+        ok = ok && Xoshiro::encode_wire(rngs.data(), count, bytes.data()) == bytes.size();
+
+        Xoshiro::WireHeader header;
+        ok = ok && Xoshiro::read_wire_header(bytes.data(), bytes.size(), header)
+                && header.version == Xoshiro::WIRE_VERSION && header.tag == rng_t::wire_tag && header.count == count;
+
+        std::vector<rng_t> decoded(count + 1);
+        std::size_t n = 0;
+        ok = ok && Xoshiro::decode_wire(bytes.data(), bytes.size(), decoded.data(), decoded.size(), n) && n == count;
+        for (std::size_t ix = 0; ix < count; ix++)
+            ok = ok && decoded[ix] == rngs[ix];
+    }
+    if (!ok) std::printf("%s: round trip failed\n", name);
+    return ok;
+}
+
+/* 'decode_wire' must fail and leave 'n' and the generators untouched. */
+template <class rng_t>
+bool rejects(const std::vector<unsigned char> &bytes, const std::size_t capacity)
+{
+    const rng_t untouched(static_cast<std::uint64_t>(1));
+    std::vector<rng_t> rngs(capacity + 1, untouched);
+    std::size_t n = 12345;
+    bool ok = !Xoshiro::decode_wire(bytes.data(), bytes.size(), rngs.data(), capacity, n) && n == 12345;
+    for (const rng_t &rng : rngs)
+        ok = ok && rng == untouched;
+    return ok;
+}
+
+bool check_rejections()
+{
+    using Xoshiro::Xoshiro256PP;
+    const std::size_t count = 4;
+    const std::vector<Xoshiro256PP> rngs = streams<Xoshiro256PP>(count);
+    std::vector<unsigned char> bytes(Xoshiro::wire_size<Xoshiro256PP>(count));
+    Xoshiro::encode_wire(rngs.data(), count, bytes.data());
+
+    bool ok = true;
+    std::vector<unsigned char> bad = bytes;
+    bad[0] = 'Y';
+    ok = ok && rejects<Xoshiro256PP>(bad, count);                          /* not this format */
+    bad = bytes;
+    bad[4] = static_cast<unsigned char>(Xoshiro::WIRE_VERSION + 1);
+    ok = ok && rejects<Xoshiro256PP>(bad, count);                          /* newer version */
+    bad = bytes;
+    bad[4] = 0;
+    ok = ok && rejects<Xoshiro256PP>(bad, count);                          /* version 0 */
+    ok = ok && rejects<Xoshiro::Xoshiro256P>(bytes, count);                /* other generator */
+    ok = ok && rejects<Xoshiro256PP>(bytes, count - 1);                    /* no room */
+    bad.assign(bytes.begin(), bytes.end() - 1);
+    ok = ok && rejects<Xoshiro256PP>(bad, count);                          /* truncated states */
+    bad.assign(bytes.begin(), bytes.begin() + Xoshiro::WIRE_HEADER_BYTES - 1);
+    ok = ok && rejects<Xoshiro256PP>(bad, count);                          /* truncated header */
+    bad = bytes;
+    bad[15] = 0x80;
+    ok = ok && rejects<Xoshiro256PP>(bad, count);                          /* huge count */
+    if (!ok) std::printf("decode_wire: accepted invalid input\n");
+    return ok;
+}
+
+}
+
+int main()
+{
+    using namespace Xoshiro;
+    int failures = 0;
+    failures += !check_round_trip<Xoshiro256PP>("Xoshiro256PP");
+    failures += !check_round_trip<Xoshiro256P>("Xoshiro256P");
+    failures += !check_round_trip<Xoshiro256SS>("Xoshiro256SS");
+    failures += !check_round_trip<Xoshiro512PP>("Xoshiro512PP");
+    failures += !check_round_trip<Xoroshiro128PP>("Xoroshiro128PP");
+    failures += !check_round_trip<Xoshiro128PP>("Xoshiro128PP");
+    failures += !check_round_trip<Xoshiro128P>("Xoshiro128P");
+    failures += !check_rejections();
+    return failures? 1 : 0;
+}
@@ -0,0 +1,75 @@
+/* Checks the ziggurat tables: 'F[i]' is the density at 'X[i]', the edges
+   decrease from 'X[1]' = 'R' down to 'X[256]' = 0, and every layer, the base
+   one with its tail included, has the same area. Then checks the mean and
+   variance of 'fill_normal' and 'fill_exponential':
+
+       g++ -std=c++17 -O2 -I. tests/ziggurat.cpp -o ziggurat && ./ziggurat
+
+   Exits with a non-zero status if any check fails. */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+bool close(const double a, const double b, const double tolerance)
+{
+    return std::fabs(a - b) <= tolerance * std::fabs(b);
+}
+
+/* 'tail' is the area under 'f' beyond 'R'. */
+template <class density_t>
+bool check_tables(const char *name, const double *X, const double *F, const double R, const double tail,
+                  density_t f)
+{
+    bool ok = X[1] == R && X[256] == 0 && F[256] == 1;
+    const double V = R * f(R) + tail;
+    ok = ok && close(X[0] * F[1], V, 1e-10);
+    for (int i = 0; i < 257; i++)
+        ok = ok && close(F[i], f(X[i]), 1e-15);
+    for (int i = 1; i < 256; i++)
+        ok = ok && X[i + 1] < X[i] && close(X[i] * (F[i + 1] - F[i]), V, 1e-8);
+    if (!ok) std::printf("%s: wrong tables\n", name);
+    return ok;
+}
+
+bool check_moments(const char *name, const std::vector<double> &values, const double mean, const double variance)
+{
+    double sum = 0, sum2 = 0;
+    for (const double x : values)
+    {
+        sum += x;
+        sum2 += x * x;
+    }
+    const double n = static_cast<double>(values.size());
+    const double m = sum / n;
+    const double v = sum2 / n - m * m;
+    /* about 5 standard errors for these sample sizes */
+    const bool ok = std::fabs(m - mean) < 5 * std::sqrt(variance / n) && std::fabs(v - variance) < 0.01 * variance;
+    if (!ok) std::printf("%s: mean %g and variance %g\n", name, m, v);
+    return ok;
+}
+
+}
+
+int main()
+{
+    using namespace Xoshiro;
+    int failures = 0;
+    const double pi = 3.14159265358979323846;
+    failures += !check_tables("normal", ZIGGURAT_NORMAL_X, ZIGGURAT_NORMAL_F, ZIGGURAT_NORMAL_R,
+                              std::sqrt(pi / 2) * std::erfc(ZIGGURAT_NORMAL_R / std::sqrt(2.0)),
+                              [](const double x) { return std::exp(-0.5 * x * x); });
+    failures += !check_tables("exponential", ZIGGURAT_EXP_X, ZIGGURAT_EXP_F, ZIGGURAT_EXP_R,
+                              std::exp(-ZIGGURAT_EXP_R),
+                              [](const double x) { return std::exp(-x); });
+
+    Xoshiro256PP rng(static_cast<std::uint64_t>(99));
+    std::vector<double> values(1 << 22);
+    fill_normal(rng, values.data(), values.size(), 1.0, 2.0);
+    failures += !check_moments("fill_normal", values, 1.0, 4.0);
+    fill_exponential(rng, values.data(), values.size(), 0.5);
+    failures += !check_moments("fill_exponential", values, 2.0, 4.0);
+    return failures? 1 : 0;
+}
@@ -0,0 +1,272 @@
+/* Streams the raw output of any of the generators, as bytes in memory order,
+   for statistical test suites. By default the output goes to stdout:
+
+       g++ -std=c++17 -O2 -march=native -pthread -I. tools/rng_stream.cpp -o rng_stream
+       ./rng_stream xoshiro256pp lanes8 | RNG_test stdin64
+
+   (use 'stdin32' for the 32-bit generators). When compiled with
+   -DXOSHIRO_TESTU01 and linked with TestU01 (-ltestu01 -lprobdist -lmylib),
+   '--battery small|crush|big' runs that battery in-process instead, on the
+   output taken as 32-bit words.
+
+   The modes select which generation path is tested:
+       scalar      'operator()' one value at a time
+       fill        'fill' on the scalar generator
+       lanesW      'XoshiroLanes<rng_t, W>::fill', lanes interleaved (W = 4, 8 or 16)
+       substreams  '--streams' streams of 'make_streams', interleaved value by
+                   value, which also goes through the batched jumps
+   Other options: '--seed S' (default 0) and '--bytes N' to stop after N bytes
+   (default 0, no limit). */
+#include "xoshiro.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef XOSHIRO_TESTU01
+extern "C"
+{
+#   include "unif01.h"
+#   include "bbattery.h"
+}
+#endif
+
+namespace {
+
+constexpr std::size_t BUFFER_BYTES = 1 << 20;
+
+/* Gives the output in blocks of 'block_bytes()' bytes, BUFFER_BYTES unless
+   the mode cannot fill exactly that many. */
+class Source
+{
+public:
+    virtual ~Source() {}
+
+    virtual const unsigned char* next() = 0;
+
+    virtual std::size_t block_bytes() const
+    {
+        return BUFFER_BYTES;
+    }
+};
+
+template <class rng_t>
+class ScalarSource : public Source
+{
+public:
+    using result_type = typename rng_t::result_type;
+
+    explicit ScalarSource(const rng_t &rng) : rng(rng), buffer(BUFFER_BYTES / sizeof(result_type)) {}
+
+    const unsigned char* next() override
+    {
+        for (std::size_t ix = 0; ix < this->buffer.size(); ix++)
+            this->buffer[ix] = this->rng();
+        return reinterpret_cast<const unsigned char*>(this->buffer.data());
+    }
+
+private:
+    rng_t rng;
+    std::vector<result_type> buffer;
+};
+
+/* 'gen_t' is the generator itself or a 'XoshiroLanes' of it. The latter is
+   over-aligned, so it is kept in a (cache-aligned) 'StreamArray' rather than
+   as a member, for 'new FillSource' to work before C++17 too. */
+template <class gen_t>
+class FillSource : public Source
+{
+public:
+    using result_type = typename gen_t::result_type;
+
+    explicit FillSource(const gen_t &gen) : gen(1), buffer(BUFFER_BYTES / sizeof(result_type))
+    {
+        this->gen[0] = gen;
+    }
+
+    const unsigned char* next() override
+    {
+        this->gen[0].fill(this->buffer.data(), this->buffer.size());
+        return reinterpret_cast<const unsigned char*>(this->buffer.data());
+    }
+
+private:
+    Xoshiro::StreamArray<gen_t> gen;
+    std::vector<result_type> buffer;
+};
+
+/* Each stream fills its share of the block, which is then interleaved so
+   that consecutive values come from consecutive streams. The block is the
+   largest multiple of the number of streams that fits in BUFFER_BYTES. */
+template <class rng_t>
+class SubstreamSource : public Source
+{
+public:
+    using result_type = typename rng_t::result_type;
+
+    SubstreamSource(const rng_t &base, const std::size_t n_streams)
+        : streams(Xoshiro::make_streams(base, n_streams)),
+          per_stream(BUFFER_BYTES / sizeof(result_type) / n_streams),
+          chunk(per_stream), buffer(per_stream * n_streams)
+    {}
+
+    std::size_t block_bytes() const override
+    {
+        return this->buffer.size() * sizeof(result_type);
+    }
+
+    const unsigned char* next() override
+    {
+        const std::size_t n_streams = this->streams.size();
+        for (std::size_t s = 0; s < n_streams; s++)
+        {
+            this->streams[s].fill(this->chunk.data(), this->per_stream);
+            for (std::size_t ix = 0; ix < this->per_stream; ix++)
+                this->buffer[ix*n_streams + s] = this->chunk[ix];
+        }
+        return reinterpret_cast<const unsigned char*>(this->buffer.data());
+    }
+
+private:
+    Xoshiro::StreamArray<rng_t> streams;
+    const std::size_t per_stream;
+    std::vector<result_type> chunk;
+    std::vector<result_type> buffer;
+};
+
+template <class rng_t>
+std::unique_ptr<Source> make_source(const std::string &mode, const std::uint64_t seed, const std::size_t n_streams)
+{
+    using source_ptr = std::unique_ptr<Source>;
+    const rng_t rng(seed);
+    if (mode == "scalar")
+        return source_ptr(new ScalarSource<rng_t>(rng));
+    if (mode == "fill")
+        return source_ptr(new FillSource<rng_t>(rng));
+    if (mode == "lanes4")
+        return source_ptr(new FillSource<Xoshiro::XoshiroLanes<rng_t, 4>>(Xoshiro::XoshiroLanes<rng_t, 4>(rng)));
+    if (mode == "lanes8")
+        return source_ptr(new FillSource<Xoshiro::XoshiroLanes<rng_t, 8>>(Xoshiro::XoshiroLanes<rng_t, 8>(rng)));
+    if (mode == "lanes16")
+        return source_ptr(new FillSource<Xoshiro::XoshiroLanes<rng_t, 16>>(Xoshiro::XoshiroLanes<rng_t, 16>(rng)));
+    if (mode == "substreams")
+        return source_ptr(new SubstreamSource<rng_t>(rng, n_streams));
+    return source_ptr();
+}
+
+std::unique_ptr<Source> make_source(const std::string &engine, const std::string &mode,
+                                    const std::uint64_t seed, const std::size_t n_streams)
+{
+    if (engine == "xoshiro256pp") return make_source<Xoshiro::Xoshiro256PP>(mode, seed, n_streams);
+    if (engine == "xoshiro256p") return make_source<Xoshiro::Xoshiro256P>(mode, seed, n_streams);
+    if (engine == "xoshiro256ss") return make_source<Xoshiro::Xoshiro256SS>(mode, seed, n_streams);
+    if (engine == "xoshiro512pp") return make_source<Xoshiro::Xoshiro512PP>(mode, seed, n_streams);
+    if (engine == "xoroshiro128pp") return make_source<Xoshiro::Xoroshiro128PP>(mode, seed, n_streams);
+    if (engine == "xoshiro128pp") return make_source<Xoshiro::Xoshiro128PP>(mode, seed, n_streams);
+    if (engine == "xoshiro128p") return make_source<Xoshiro::Xoshiro128P>(mode, seed, n_streams);
+    return std::unique_ptr<Source>();
+}
+
+#ifdef XOSHIRO_TESTU01
+Source *testu01_source = nullptr;
+const unsigned char *testu01_block = nullptr;
+std::size_t testu01_pos = 0;
+std::size_t testu01_size = 0;
+
+unsigned int testu01_bits()
+{
+    if (testu01_pos == testu01_size)
+    {
+        testu01_block = testu01_source->next();
+        testu01_size = testu01_source->block_bytes();
+        testu01_pos = 0;
+    }
+    std::uint32_t out;
+    std::memcpy(&out, testu01_block + testu01_pos, sizeof(out));
+    testu01_pos += sizeof(out);
+    return out;
+}
+
+int run_battery(Source &source, const std::string &battery, std::string name)
+{
+    testu01_source = &source;
+    unif01_Gen *gen = unif01_CreateExternGenBits(&name[0], testu01_bits);
+    if (battery == "small") bbattery_SmallCrush(gen);
+    else if (battery == "crush") bbattery_Crush(gen);
+    else if (battery == "big") bbattery_BigCrush(gen);
+    else
+    {
+        std::fprintf(stderr, "unknown battery '%s'\n", battery.c_str());
+        unif01_DeleteExternGenBits(gen);
+        return 1;
+    }
+    unif01_DeleteExternGenBits(gen);
+    return 0;
+}
+#endif
+
+int usage(const char *program)
+{
+    std::fprintf(stderr, "usage: %s ENGINE [scalar|fill|lanes4|lanes8|lanes16|substreams]"
+                         " [--seed S] [--streams K] [--bytes N]"
+                         #ifdef XOSHIRO_TESTU01
+                         " [--battery small|crush|big]"
+                         #endif
+                         "\nengines: xoshiro256pp xoshiro256p xoshiro256ss xoshiro512pp"
+                         " xoroshiro128pp xoshiro128pp xoshiro128p\n", program);
+    return 2;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) return usage(argv[0]);
+    std::string engine = argv[1];
+    std::string mode = "fill";
+    std::string battery;
+    std::uint64_t seed = 0;
+    std::size_t n_streams = 64;
+    unsigned long long max_bytes = 0;
+    for (int ix = 2; ix < argc; ix++)
+    {
+        const std::string arg = argv[ix];
+        const bool has_value = ix + 1 < argc;
+        if (arg == "--seed" && has_value) seed = std::strtoull(argv[++ix], nullptr, 0);
+        else if (arg == "--streams" && has_value) n_streams = std::strtoull(argv[++ix], nullptr, 0);
+        else if (arg == "--bytes" && has_value) max_bytes = std::strtoull(argv[++ix], nullptr, 0);
+        else if (arg == "--battery" && has_value) battery = argv[++ix];
+        else if (arg.compare(0, 2, "--") != 0) mode = arg;
+        else return usage(argv[0]);
+    }
+    if (!n_streams || n_streams > BUFFER_BYTES / 8)
+    {
+        std::fprintf(stderr, "--streams must be between 1 and %zu\n", BUFFER_BYTES / 8);
+        return 2;
+    }
+    const std::unique_ptr<Source> source = make_source(engine, mode, seed, n_streams);
+    if (!source) return usage(argv[0]);
+
+    if (!battery.empty())
+    {
+        #ifdef XOSHIRO_TESTU01
+        return run_battery(*source, battery, engine + " " + mode);
+        #else
+        std::fprintf(stderr, "--battery needs compiling with -DXOSHIRO_TESTU01\n");
+        return 2;
+        #endif
+    }
+
+    const std::size_t block_bytes = source->block_bytes();
+    for (unsigned long long written = 0; !max_bytes || written < max_bytes; written += block_bytes)
+    {
+        const std::size_t n = (max_bytes && max_bytes - written < block_bytes)?
+                              static_cast<std::size_t>(max_bytes - written) : block_bytes;
+        if (std::fwrite(source->next(), 1, n, stdout) != n)
+            break;
+    }
+    return 0;
+}
@@ -15,412 +15,4952 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 #include <iostream>
 #include <cstring>
 #include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+#include <new>
+#include <utility>
+#include <atomic>
+#include <iterator>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <random>
+#include <cerrno>
+#include <stdexcept>
+#if __cplusplus >= 202001L
+#   include <span>
+#endif
+#if defined(__AVX2__) || defined(__AVX512F__)
+#   include <immintrin.h>
+#elif defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#   include <arm_neon.h>
+#endif
+#if defined(__ARM_FEATURE_SVE)
+#   include <arm_sve.h>
+#endif
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+#   include <coroutine>
+#   define XOSHIRO_HAS_COROUTINES
+#endif
+#if defined(__linux__) && defined(__has_include)
+#   if __has_include(<sys/random.h>)
+#       include <sys/random.h>
+#       define XOSHIRO_HAS_GETRANDOM
+#   endif
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#   include <cstdlib>
+#   define XOSHIRO_HAS_ARC4RANDOM
+#endif
+#if defined(XOSHIRO_NUMA)
+#   include <numa.h>
+#   include <sched.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#endif
+
+namespace Xoshiro {
+
+
+#if __cplusplus >= 202001L
+#   define HAS_CPP20
+#endif
+
+/* Seeding, stepping and jumping can be evaluated at compile time from C++14
+   on (C++11 constexpr functions are limited to a single return statement),
+   e.g. for tables of generators computed by the compiler. */
+#if __cplusplus >= 201402L
+#   define XOSHIRO_CONSTEXPR constexpr
+#else
+#   define XOSHIRO_CONSTEXPR
+#endif
+
+/* Marks the core of the generators (rotations, state transitions, output
+   functions, seeding from a number or from state words, stepping and
+   'jump_state') as callable from CUDA and HIP device code, which is where
+   the same sequences as on the host are needed for validation. All the rest
+   (tables, jumps by name, streams, I/O) stays on the host: streams are set
+   up there and copied to the device in the layout of 'make_soa_streams'. */
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#   define XOSHIRO_HOST_DEVICE __host__ __device__
+#else
+#   define XOSHIRO_HOST_DEVICE
+#endif
+
+/* Loops over the words of a state have a fixed and small trip count, but they
+   need to be unrolled for the words to stay in registers, which compilers do
+   not always do on their own at -O2. */
+#if defined(__clang__)
+#   define XOSHIRO_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+#   define XOSHIRO_UNROLL _Pragma("GCC unroll 8")
+#else
+#   define XOSHIRO_UNROLL
+#endif
+
+/* Whether the host stores words little-endian, in which case the byte layout
+   of saved states (below) is the same as the layout in memory. */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+#   define XOSHIRO_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#elif defined(_MSC_VER)
+#   define XOSHIRO_LITTLE_ENDIAN 1
+#else
+#   define XOSHIRO_LITTLE_ENDIAN 0
+#endif
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint64_t rotl64(const std::uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint32_t rotl32(const std::uint32_t x, const int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+/* Rotations with the amount as a template parameter, so that the same step
+   function can be instantiated for plain words and for 'LaneVector' below
+   (some SIMD rotate instructions only take immediate operands). */
+template <int k>
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint64_t rotl(const std::uint64_t x) {
+    return rotl64(x, k);
+}
+
+template <int k>
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint32_t rotl(const std::uint32_t x) {
+    return rotl32(x, k);
+}
+
+/* Group of 'W' words of type 'int_t' operated on element-wise. This is the
+   portable version; specializations using intrinsics follow when the target
+   supports them ('native'). Compilers do not vectorize the portable version
+   well enough to beat the scalar generators, so 'XoshiroLanes' picks its
+   vector type with 'LaneVectorSelect' below. */
+template <class int_t, int W>
+struct LaneVector
+{
+    constexpr static const bool native = false;
+    int_t v[W];
+
+    static inline LaneVector load(const int_t *ptr)
+    {
+        LaneVector out;
+        std::memcpy(out.v, ptr, W*sizeof(int_t));
+        return out;
+    }
+
+    inline void store(int_t *ptr) const
+    {
+        std::memcpy(ptr, this->v, W*sizeof(int_t));
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = this->v[i] ^ other.v[i];
+        return out;
+    }
+
+    static inline LaneVector broadcast(const int_t x)
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = x;
+        return out;
+    }
+
+    inline LaneVector operator&(const LaneVector &other) const
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = this->v[i] & other.v[i];
+        return out;
+    }
+
+    inline LaneVector operator|(const LaneVector &other) const
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = this->v[i] | other.v[i];
+        return out;
+    }
+
+    inline LaneVector operator+(const LaneVector &other) const
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = this->v[i] + other.v[i];
+        return out;
+    }
+
+    inline LaneVector operator<<(const int k) const
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = this->v[i] << k;
+        return out;
+    }
+
+    inline LaneVector operator>>(const int k) const
+    {
+        LaneVector out;
+        for (int i = 0; i < W; i++) out.v[i] = this->v[i] >> k;
+        return out;
+    }
+
+    inline LaneVector& operator^=(const LaneVector &other)
+    {
+        return *this = *this ^ other;
+    }
+};
+
+template <int k, class int_t, int W>
+static inline LaneVector<int_t, W> rotl(const LaneVector<int_t, W> &x) {
+    return (x << k) | (x >> (8*static_cast<int>(sizeof(int_t)) - k));
+}
+
+#ifdef __SSE2__
+template <>
+struct LaneVector<std::uint64_t, 2>
+{
+    constexpr static const bool native = true;
+    __m128i v;
+
+    static inline LaneVector load(const std::uint64_t *ptr)
+    {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))};
+    }
+
+    inline void store(std::uint64_t *ptr) const
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {_mm_xor_si128(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint64_t x) { return {_mm_set1_epi64x(static_cast<long long>(x))}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {_mm_and_si128(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {_mm_or_si128(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {_mm_add_epi64(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {_mm_slli_epi64(this->v, k)}; }
+    inline LaneVector operator>>(const int k) const { return {_mm_srli_epi64(this->v, k)}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = _mm_xor_si128(this->v, other.v); return *this; }
+};
+
+template <>
+struct LaneVector<std::uint32_t, 4>
+{
+    constexpr static const bool native = true;
+    __m128i v;
+
+    static inline LaneVector load(const std::uint32_t *ptr)
+    {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))};
+    }
+
+    inline void store(std::uint32_t *ptr) const
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {_mm_xor_si128(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint32_t x) { return {_mm_set1_epi32(static_cast<int>(x))}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {_mm_and_si128(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {_mm_or_si128(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {_mm_add_epi32(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {_mm_slli_epi32(this->v, k)}; }
+    inline LaneVector operator>>(const int k) const { return {_mm_srli_epi32(this->v, k)}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = _mm_xor_si128(this->v, other.v); return *this; }
+};
+
+#ifdef __AVX512VL__
+template <int k>
+static inline LaneVector<std::uint64_t, 2> rotl(const LaneVector<std::uint64_t, 2> &x) {
+    return {_mm_rol_epi64(x.v, k)};
+}
+
+template <int k>
+static inline LaneVector<std::uint32_t, 4> rotl(const LaneVector<std::uint32_t, 4> &x) {
+    return {_mm_rol_epi32(x.v, k)};
+}
+#endif
+#endif /* __SSE2__ */
+
+#ifdef __AVX2__
+template <>
+struct LaneVector<std::uint64_t, 4>
+{
+    constexpr static const bool native = true;
+    __m256i v;
+
+    static inline LaneVector load(const std::uint64_t *ptr)
+    {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr))};
+    }
+
+    inline void store(std::uint64_t *ptr) const
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {_mm256_xor_si256(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint64_t x) { return {_mm256_set1_epi64x(static_cast<long long>(x))}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {_mm256_and_si256(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {_mm256_or_si256(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {_mm256_add_epi64(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {_mm256_slli_epi64(this->v, k)}; }
+    inline LaneVector operator>>(const int k) const { return {_mm256_srli_epi64(this->v, k)}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = _mm256_xor_si256(this->v, other.v); return *this; }
+};
+
+template <>
+struct LaneVector<std::uint32_t, 8>
+{
+    constexpr static const bool native = true;
+    __m256i v;
+
+    static inline LaneVector load(const std::uint32_t *ptr)
+    {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr))};
+    }
+
+    inline void store(std::uint32_t *ptr) const
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {_mm256_xor_si256(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint32_t x) { return {_mm256_set1_epi32(static_cast<int>(x))}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {_mm256_and_si256(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {_mm256_or_si256(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {_mm256_add_epi32(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {_mm256_slli_epi32(this->v, k)}; }
+    inline LaneVector operator>>(const int k) const { return {_mm256_srli_epi32(this->v, k)}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = _mm256_xor_si256(this->v, other.v); return *this; }
+};
+
+#ifdef __AVX512VL__
+template <int k>
+static inline LaneVector<std::uint64_t, 4> rotl(const LaneVector<std::uint64_t, 4> &x) {
+    return {_mm256_rol_epi64(x.v, k)};
+}
+
+template <int k>
+static inline LaneVector<std::uint32_t, 8> rotl(const LaneVector<std::uint32_t, 8> &x) {
+    return {_mm256_rol_epi32(x.v, k)};
+}
+#endif
+#endif /* __AVX2__ */
+
+#ifdef __AVX512F__
+/* GCC before 13 warns that the unused merge operand ('__Y') of the masked
+   builtins behind these intrinsics is (or may be) used uninitialized. */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wuninitialized"
+#   pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+template <>
+struct LaneVector<std::uint64_t, 8>
+{
+    constexpr static const bool native = true;
+    __m512i v;
+
+    static inline LaneVector load(const std::uint64_t *ptr)
+    {
+        return {_mm512_loadu_si512(ptr)};
+    }
+
+    inline void store(std::uint64_t *ptr) const
+    {
+        _mm512_storeu_si512(ptr, this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {_mm512_xor_si512(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint64_t x) { return {_mm512_set1_epi64(static_cast<long long>(x))}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {_mm512_and_si512(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {_mm512_or_si512(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {_mm512_add_epi64(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {_mm512_slli_epi64(this->v, k)}; }
+    inline LaneVector operator>>(const int k) const { return {_mm512_srli_epi64(this->v, k)}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = _mm512_xor_si512(this->v, other.v); return *this; }
+};
+
+template <int k>
+static inline LaneVector<std::uint64_t, 8> rotl(const LaneVector<std::uint64_t, 8> &x) {
+    return {_mm512_rol_epi64(x.v, k)};
+}
+
+template <>
+struct LaneVector<std::uint32_t, 16>
+{
+    constexpr static const bool native = true;
+    __m512i v;
+
+    static inline LaneVector load(const std::uint32_t *ptr)
+    {
+        return {_mm512_loadu_si512(ptr)};
+    }
+
+    inline void store(std::uint32_t *ptr) const
+    {
+        _mm512_storeu_si512(ptr, this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {_mm512_xor_si512(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint32_t x) { return {_mm512_set1_epi32(static_cast<int>(x))}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {_mm512_and_si512(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {_mm512_or_si512(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {_mm512_add_epi32(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {_mm512_slli_epi32(this->v, k)}; }
+    inline LaneVector operator>>(const int k) const { return {_mm512_srli_epi32(this->v, k)}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = _mm512_xor_si512(this->v, other.v); return *this; }
+};
+
+template <int k>
+static inline LaneVector<std::uint32_t, 16> rotl(const LaneVector<std::uint32_t, 16> &x) {
+    return {_mm512_rol_epi32(x.v, k)};
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#   pragma GCC diagnostic pop
+#endif
+#endif /* __AVX512F__ */
+
+#ifdef __ARM_NEON
+template <>
+struct LaneVector<std::uint32_t, 4>
+{
+    constexpr static const bool native = true;
+    uint32x4_t v;
+
+    static inline LaneVector load(const std::uint32_t *ptr)
+    {
+        return {vld1q_u32(ptr)};
+    }
+
+    inline void store(std::uint32_t *ptr) const
+    {
+        vst1q_u32(ptr, this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {veorq_u32(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint32_t x) { return {vdupq_n_u32(x)}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {vandq_u32(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {vorrq_u32(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {vaddq_u32(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {vshlq_u32(this->v, vdupq_n_s32(k))}; }
+    inline LaneVector operator>>(const int k) const { return {vshlq_u32(this->v, vdupq_n_s32(-k))}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = veorq_u32(this->v, other.v); return *this; }
+};
+
+template <int k>
+static inline LaneVector<std::uint32_t, 4> rotl(const LaneVector<std::uint32_t, 4> &x) {
+    return {vsliq_n_u32(vshrq_n_u32(x.v, 32 - k), x.v, k)};
+}
+
+template <>
+struct LaneVector<std::uint64_t, 2>
+{
+    constexpr static const bool native = true;
+    uint64x2_t v;
+
+    static inline LaneVector load(const std::uint64_t *ptr)
+    {
+        return {vld1q_u64(ptr)};
+    }
+
+    inline void store(std::uint64_t *ptr) const
+    {
+        vst1q_u64(ptr, this->v);
+    }
+
+    inline LaneVector operator^(const LaneVector &other) const { return {veorq_u64(this->v, other.v)}; }
+    static inline LaneVector broadcast(const std::uint64_t x) { return {vdupq_n_u64(x)}; }
+    inline LaneVector operator&(const LaneVector &other) const { return {vandq_u64(this->v, other.v)}; }
+    inline LaneVector operator|(const LaneVector &other) const { return {vorrq_u64(this->v, other.v)}; }
+    inline LaneVector operator+(const LaneVector &other) const { return {vaddq_u64(this->v, other.v)}; }
+    inline LaneVector operator<<(const int k) const { return {vshlq_u64(this->v, vdupq_n_s64(k))}; }
+    inline LaneVector operator>>(const int k) const { return {vshlq_u64(this->v, vdupq_n_s64(-k))}; }
+    inline LaneVector& operator^=(const LaneVector &other) { this->v = veorq_u64(this->v, other.v); return *this; }
+};
+
+template <int k>
+static inline LaneVector<std::uint64_t, 2> rotl(const LaneVector<std::uint64_t, 2> &x) {
+    return {vsliq_n_u64(vshrq_n_u64(x.v, 64 - k), x.v, k)};
+}
+#endif /* __ARM_NEON */
+
+template <class int_t, int W>
+struct LaneVectorPair;
+
+/* The vector type 'XoshiroLanes<rng_t, W>' steps its lanes with: the
+   'LaneVector' itself when it is native, otherwise a 'LaneVectorPair' of two
+   native halves (e.g. 8 64-bit lanes in two AVX2 registers), and otherwise
+   the portable version with 'native' false, in which case the lanes are run
+   one after the other by the scalar generator instead. */
+template <class int_t, int W, bool = LaneVector<int_t, W>::native>
+struct LaneVectorSelect
+{
+    using type = LaneVector<int_t, W>;
+    constexpr static const bool native = true;
+};
+
+template <class int_t, int W>
+struct LaneVectorSelect<int_t, W, false>
+{
+    constexpr static const bool native = (W > 1) && (W % 2 == 0) && LaneVectorSelect<int_t, W/2>::native;
+    using type = typename std::conditional<native, LaneVectorPair<int_t, W>, LaneVector<int_t, W>>::type;
+};
+
+template <class int_t>
+struct LaneVectorSelect<int_t, 1, false>
+{
+    using type = LaneVector<int_t, 1>;
+    constexpr static const bool native = false;
+};
+
+/* 'W' lanes as two halves of 'W/2', each in native registers. */
+template <class int_t, int W>
+struct LaneVectorPair
+{
+    using half_type = typename LaneVectorSelect<int_t, W/2>::type;
+    half_type lo;
+    half_type hi;
+
+    static inline LaneVectorPair load(const int_t *ptr)
+    {
+        return {half_type::load(ptr), half_type::load(ptr + W/2)};
+    }
+
+    inline void store(int_t *ptr) const
+    {
+        this->lo.store(ptr);
+        this->hi.store(ptr + W/2);
+    }
+
+    inline LaneVectorPair operator^(const LaneVectorPair &other) const { return {this->lo ^ other.lo, this->hi ^ other.hi}; }
+    static inline LaneVectorPair broadcast(const int_t x) { return {half_type::broadcast(x), half_type::broadcast(x)}; }
+    inline LaneVectorPair operator&(const LaneVectorPair &other) const { return {this->lo & other.lo, this->hi & other.hi}; }
+    inline LaneVectorPair operator|(const LaneVectorPair &other) const { return {this->lo | other.lo, this->hi | other.hi}; }
+    inline LaneVectorPair operator+(const LaneVectorPair &other) const { return {this->lo + other.lo, this->hi + other.hi}; }
+    inline LaneVectorPair operator<<(const int k) const { return {this->lo << k, this->hi << k}; }
+    inline LaneVectorPair operator>>(const int k) const { return {this->lo >> k, this->hi >> k}; }
+    inline LaneVectorPair& operator^=(const LaneVectorPair &other) { this->lo ^= other.lo; this->hi ^= other.hi; return *this; }
+};
+
+template <int k, class int_t, int W>
+static inline LaneVectorPair<int_t, W> rotl(const LaneVectorPair<int_t, W> &x) {
+    return {rotl<k>(x.lo), rotl<k>(x.hi)};
+}
+
+/* Number of 32-bit and 64-bit words in one hardware vector register, which is
+   the natural choice of 'W' for 'XoshiroLanes'. With SVE the vector length is
+   only known at run time, so this queries the hardware. */
+static inline int vector_lanes32()
+{
+#if defined(__ARM_FEATURE_SVE)
+    return static_cast<int>(svcntw());
+#elif defined(__AVX512F__)
+    return 16;
+#elif defined(__AVX2__)
+    return 8;
+#else
+    return 4;
+#endif
+}
+
+static inline int vector_lanes64()
+{
+#if defined(__ARM_FEATURE_SVE)
+    return static_cast<int>(svcntd());
+#elif defined(__AVX512F__)
+    return 8;
+#elif defined(__AVX2__)
+    return 4;
+#else
+    return 2;
+#endif
+}
+
+/* The 32-bit halves of a 64-bit word as laid out in memory, 'left' being the
+   one at the lower address. These use shifts rather than pointer casts, to
+   avoid gcc warnings about 'strict aliasing rules' and to be constexpr. */
+constexpr static const int LEFT_HALF_SHIFT = XOSHIRO_LITTLE_ENDIAN? 0 : 32;
+
+constexpr static const int RIGHT_HALF_SHIFT = 32 - LEFT_HALF_SHIFT;
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint32_t extract_32bits_from64_left(const std::uint64_t x)
+{
+    return static_cast<std::uint32_t>(x >> LEFT_HALF_SHIFT);
+}
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint32_t extract_32bits_from64_right(const std::uint64_t x)
+{
+    return static_cast<std::uint32_t>(x >> RIGHT_HALF_SHIFT);
+}
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void assign_32bits_to64_left(std::uint64_t &assign_to, const std::uint32_t take_from)
+{
+    assign_to = (assign_to & ~(std::uint64_t(0xffffffff) << LEFT_HALF_SHIFT))
+              | (static_cast<std::uint64_t>(take_from) << LEFT_HALF_SHIFT);
+}
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void assign_32bits_to64_right(std::uint64_t &assign_to, const std::uint32_t take_from)
+{
+    assign_to = (assign_to & ~(std::uint64_t(0xffffffff) << RIGHT_HALF_SHIFT))
+              | (static_cast<std::uint64_t>(take_from) << RIGHT_HALF_SHIFT);
+}
+
+/* Uniform reals in [0, 1) built directly from the highest bits of the outputs,
+   taking as many bits as the mantissa holds, so every value is a multiple of
+   2^-53 (double) or 2^-24 (float). */
+constexpr static const double TWO_POW_MINUS_53 = 1.0 / 9007199254740992.0;
+
+constexpr static const float TWO_POW_MINUS_24 = 1.0f / 16777216.0f;
+
+static inline double u64_to_double(const std::uint64_t x)
+{
+    return static_cast<double>(x >> 11) * TWO_POW_MINUS_53;
+}
+
+static inline float u64_to_float(const std::uint64_t x)
+{
+    return static_cast<float>(x >> 40) * TWO_POW_MINUS_24;
+}
+
+static inline float u32_to_float(const std::uint32_t x)
+{
+    return static_cast<float>(x >> 8) * TWO_POW_MINUS_24;
+}
+
+/* doubles from 32-bit outputs take two of them, the first one giving the highest bits */
+static inline double u32_pair_to_double(const std::uint32_t hi, const std::uint32_t lo)
+{
+    return u64_to_double((static_cast<std::uint64_t>(hi) << 32) | lo);
+}
+
+/* Converts raw outputs to reals with the functions above; for doubles from
+   32-bit outputs, 'raw' holds 2*n values. */
+static inline void raw_to_uniform(const std::uint64_t *raw, double *out, const std::size_t n)
+{
+    for (std::size_t ix = 0; ix < n; ix++)
+        out[ix] = u64_to_double(raw[ix]);
+}
+
+static inline void raw_to_uniform(const std::uint64_t *raw, float *out, const std::size_t n)
+{
+    for (std::size_t ix = 0; ix < n; ix++)
+        out[ix] = u64_to_float(raw[ix]);
+}
+
+static inline void raw_to_uniform(const std::uint32_t *raw, float *out, const std::size_t n)
+{
+    for (std::size_t ix = 0; ix < n; ix++)
+        out[ix] = u32_to_float(raw[ix]);
+}
+
+static inline void raw_to_uniform(const std::uint32_t *raw, double *out, const std::size_t n)
+{
+    for (std::size_t ix = 0; ix < n; ix++)
+        out[ix] = u32_pair_to_double(raw[2*ix], raw[2*ix + 1]);
+}
+
+#ifdef __SIZEOF_INT128__
+/* '__extension__' keeps -Wpedantic quiet about the non-standard type. */
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+/* Full product of two words: returns the high half and stores the low half in 'lo'. */
+static inline std::uint64_t mul_wide(const std::uint64_t a, const std::uint64_t b, std::uint64_t &lo)
+{
+    #ifdef __SIZEOF_INT128__
+    const uint128_t product = static_cast<uint128_t>(a) * b;
+    lo = static_cast<std::uint64_t>(product);
+    return static_cast<std::uint64_t>(product >> 64);
+    #else
+    const std::uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    const std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    const std::uint64_t mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+    lo = (mid << 32) | (ll & 0xffffffff);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    #endif
+}
+
+static inline std::uint32_t mul_wide(const std::uint32_t a, const std::uint32_t b, std::uint32_t &lo)
+{
+    const std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+    lo = static_cast<std::uint32_t>(product);
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+constexpr static const uint64_t JUMP_X256PP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+
+constexpr static const uint64_t LONG_JUMP_X256PP[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
+
+constexpr static const uint32_t JUMP_X128PP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+constexpr static const uint32_t LONG_JUMP_X128PP[] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+constexpr static const uint64_t JUMP_X512PP[] = {
+    0x33ed89b6e7a353f9, 0x760083d7955323be, 0x2837f2fbb5f22fae, 0x4b8c5674d309511c,
+    0xb11ac47a7ba28c25, 0xf1be7667092bcc1c, 0x53851efdb6df0aaf, 0x1ebbc8b23eaf25db
+};
+
+constexpr static const uint64_t LONG_JUMP_X512PP[] = {
+    0x11467fef8f921d28, 0xa2a819f2e79c8ea8, 0xa8299fc284b3959a, 0xb4d347340ca63ee1,
+    0x1cb0940bedbff6ce, 0xd956c5c4fa1f8e17, 0x915e38fd4eda93bc, 0x5b3ccdfa5d7daca5
+};
+
+constexpr static const uint64_t JUMP_XORO128PP[] = { 0x2bd7a6a6e99c2ddc, 0x0992ccaf6a6fca05 };
+
+constexpr static const uint64_t LONG_JUMP_XORO128PP[] = { 0x360fd5f2cf8d5d99, 0x9c6e6877736c46e3 };
+
+/* Jump polynomials for advancing the state by 2^k steps, for k = 0..63 (row k),
+   used by 'discard'. */
+constexpr static const uint64_t JUMP_POW2_X256PP[64][4] = {
+    { 0x0000000000000002, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000004, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000010, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000100, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000010000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000100000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000000, 0x0000000000000001, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000000, 0x0000000000000000, 0x0000000000000001, 0x0000000000000000 },
+    { 0x9d116f2bb0f0f001, 0x0280002bcefd1a5e, 0x04b4edcf26259f85, 0x0003c03c3f3ecb19 },
+    { 0xc7327d130e34b489, 0x81f675e7a4ef7d84, 0x6dd49b656055c9da, 0xbe7976372e930435 },
+    { 0x060106bbbe4ff028, 0x1be1d76854ddda93, 0x8456faeb6230d984, 0x65507439cf43f0e2 },
+    { 0x876c2301125a85c0, 0x15fe822628b16f04, 0x3c8ca36ec9a74fa7, 0x51edef31819e01ff },
+    { 0xd7f4e8da7e228b85, 0xd638d47ec5bcf595, 0xaa6eb691cbf9ce10, 0x0f41cce3698fad39 },
+    { 0x669da12373880674, 0xb1df898a4a6f1548, 0x32104b94fe2534d3, 0xda66e09e52b341d1 },
+    { 0x4f20eb915e780231, 0x3886af219b885248, 0x023ecbee3f717fce, 0x3cec2c375bef249c },
+    { 0x449b3ae793888c8c, 0xc3ce2f061f077568, 0xa69393ac0d837e54, 0x1a9dcf944ae47603 },
+    { 0x7e89ac5ca2fbf2c7, 0x92ae7ca370c0bf6b, 0xef43beaa06f02fb8, 0xd87f8ce230817a21 },
+    { 0x6c4adbe18e29df8a, 0x54adade3697d477f, 0xf0c168649cdba61f, 0xbd53027696368bbb },
+    { 0x1a673fecf40e36b8, 0xf2c602feb5ed002b, 0x1ea49b5067452594, 0xf78a97c0d882cd37 },
+    { 0xef4606da56224c47, 0x770323eab8d437bd, 0x590923d02ec52531, 0x1639a36e0968e3c5 },
+    { 0x31d9d05c5d95f3cd, 0x7cde241817a3ce0f, 0x2f679f694a74c76a, 0x8b3919a9d298a415 },
+    { 0x6b6622ae9590047a, 0xeace6d3840b79fef, 0xd9b36372fd70ec83, 0x624eb7b63c322e71 },
+    { 0x1b91fd9ba98d9e23, 0xeb2c7e29d3c33d2e, 0xcebbfd2ef4e9aff4, 0x2bac5517c9469796 },
+    { 0x01f356e6083fe109, 0xba0ffb6562a3a28a, 0x657a6b736317866b, 0xfb678bd3e5dac186 },
+    { 0xc5461100f197a7e8, 0xe46916a1426b676d, 0xf3469dbb4fe25d26, 0xf5c010059e83bc3f },
+    { 0x22dc028cb8c259dc, 0x3eec4eb6495ce5aa, 0x5de3e273dc7b84dc, 0xe677849e207f6afd },
+    { 0x832d418900fd3b0f, 0x114e10c3b7c36788, 0xdf2332a778d9c8dc, 0x0d19a1bdceb7522c },
+    { 0xe2d0c9c10e8d7157, 0x8b3ed7c37e947e38, 0x98273f4d18ad073e, 0xf38f7e750d5f4f2a },
+    { 0xe7109518f3510d70, 0x34f30137eadb90b9, 0x6d48dd206d56754d, 0xafa9e3fe5fea15c3 },
+    { 0x8ee774f507ec9f39, 0xd7c26ebd51ecf6c4, 0xc76a456d998ddc4c, 0x1ca234ff511bcb05 },
+    { 0x4905d8261158a7bc, 0x352f8b5d2137de83, 0xe0e9fa345826626d, 0x3e667662caa54d16 },
+    { 0x272a32be4bac7912, 0xe1185a166bb38173, 0x82b9aa358fe2ed58, 0xa43d37468704d536 },
+    { 0x58120d583c112f69, 0x7d8d0632bd08e6ac, 0x214fafc0fbdbc208, 0x0e055d3520fdb9d7 },
+    { 0xd9eb3e225a9ebb7d, 0x5d33a22177777716, 0xffed2ffbcf857b42, 0xa1b7ebf581a90f09 },
+    { 0x3a433a5cff8501f4, 0x0c2e65cfa3a44f3b, 0xa59f09ab33f1c8f4, 0x0afe97309a7881b0 },
+    { 0x635e9c6882ce5c6a, 0x53a34398808ef457, 0x94295f82142a68bd, 0xc1cdf918a717c897 },
+    { 0x1a2c804af78e2ed4, 0x306c4d371040af1e, 0x63d3f9df102dfa7e, 0xac7fe0806aecd6c8 },
+    { 0x7743a154e17a5e9b, 0x7823a1cd9453899b, 0x976589eefbb1c7f5, 0x702cf168260fa29e },
+    { 0x2edfce1b0667bf3f, 0x68ef5242f2d9c5b2, 0x03803bdb9ea7d7e8, 0xc4671ec91b902bae },
+    { 0x4d2c07a0b0f7980f, 0x0af3e6140fcff185, 0xaf03bea7ea7109fd, 0x755b16e231d1e7c9 },
+    { 0xd24b31ab16542ea0, 0x13a31dc36460a3b0, 0xeece73d85df18361, 0x51fc9b8eb1974e73 },
+    { 0xec9c79ebd62a4a91, 0xa374bf9822d660aa, 0xde49d57f23fdecb5, 0xfb43cf1f4658ae1b },
+    { 0x7602414a37bf1c08, 0x48b8b0570f008a91, 0x3aa3d49368a9c562, 0x9b48db8907d00f97 },
+    { 0xf7569be74f972355, 0x9e11e129fcced20e, 0xa6994477ec2d6d85, 0x8ec1a9dd27957370 },
+    { 0xc223943200d6e8a0, 0x82f1f8d3ebd9baff, 0xf6c987b8eb4f76db, 0xba8b1a7be4521854 },
+    { 0xe226bff99e7f9d4f, 0xf6faaff592dc08c7, 0xbad2e3487a438d37, 0xa8f7de3ed772d2d2 },
+    { 0x6322f95d362137f1, 0xb006241469247fbd, 0x181d6c749bfc7e7b, 0x3c63f6f95954e65e },
+    { 0xaa878816402dab5f, 0x69811136f33b48fa, 0x0df6566ff12f17f4, 0x81f450881b843692 },
+    { 0xf11fb4faea62c7f1, 0xf825539dee5e4763, 0x474579292f705634, 0x5f728be2c97e9066 },
+    { 0xf18ac1f5eac5120e, 0x36d6c9bc4bcb56f5, 0xec104b9942b386be, 0x5ff98760441a364c },
+    { 0x12b825906ddc86af, 0x168b84ac131ea856, 0xd1c440c801f3cddf, 0xb01e1ff4eb0b05f6 },
+    { 0x5696a9ed59ffcbe3, 0xb5bb35fe03c3158a, 0xf1ab1bce1577ad4e, 0x140bd5e4e00ffdaa },
+    { 0x61507225f9f0e0fa, 0x8eadd052a304405f, 0x49c2df736ebe9c68, 0x5177664e86d5e31b },
+    { 0x87aac36cc0c1abae, 0xca120d886e8fdf33, 0x5b8d5f58ce3357a7, 0xa93a7aadeced9cd7 },
+    { 0xd4eb47064a9ac499, 0x2b95939579346af1, 0xa6f4a2ea423cc2f6, 0xd5372758d87157ef },
+    { 0x549bf83ef12aebc3, 0x56df3905d6712eed, 0xb86994c9cb3059a5, 0x7e0b8abe53e950f8 },
+    { 0x0b32b0dbe851dd9d, 0x27cc40c1479b95df, 0xc405c1164a3a6d49, 0x0888f2c33969763b },
+    { 0x920a67ed72aa1155, 0x7e5cbd2047cefb5e, 0x31acd0e23e87d9d3, 0xfecb2b39fb96f078 },
+    { 0x9841d4c5510c4700, 0x97a6c4a0d2cdf9ac, 0x82f88d9e6b9b17c0, 0xf643cc9255f06741 },
+    { 0x30ac848541c0b04f, 0x55756dedb136961f, 0x65ba2fdf5fe59ed1, 0xe8e07ed05188af0f },
+    { 0xadcede280bb92b99, 0x6d885bb5321527a7, 0x04ad0ecd62544db2, 0x679b88958f3bbdcb },
+    { 0x84db0e338a94ce16, 0xaaee46b89b106201, 0xbbf25302a56d6131, 0xd10d621b74213644 },
+    { 0xed3c94e03147ca9b, 0x31fbe8b0a2035587, 0x5083dee093b632b7, 0x6ff477672ddf72b1 },
+    { 0x936ece877e64cc97, 0x22a36cdc0fda409f, 0xbae4d9a25a3928b9, 0xa9559a2368719526 }
+};
+
+constexpr static const uint32_t JUMP_POW2_X128PP[64][4] = {
+    { 0x00000002, 0x00000000, 0x00000000, 0x00000000 },
+    { 0x00000004, 0x00000000, 0x00000000, 0x00000000 },
+    { 0x00000010, 0x00000000, 0x00000000, 0x00000000 },
+    { 0x00000100, 0x00000000, 0x00000000, 0x00000000 },
+    { 0x00010000, 0x00000000, 0x00000000, 0x00000000 },
+    { 0x00000000, 0x00000001, 0x00000000, 0x00000000 },
+    { 0x00000000, 0x00000000, 0x00000001, 0x00000000 },
+    { 0xde18fc01, 0x1b489db6, 0x006254b1, 0x00fc65a2 },
+    { 0x78bd1157, 0xb488a061, 0x77900a22, 0x0e6834fb },
+    { 0x7b0bf49a, 0x4152f743, 0x44118d9b, 0x38d2b436 },
+    { 0x845a09b1, 0x94b54ba1, 0x503a9ae6, 0x5f7aa4ff },
+    { 0x0a1f06b6, 0xece7bc8e, 0x9ab5cf0e, 0x780f1aed },
+    { 0x8fcff8d3, 0xd66b4f59, 0x07ee277a, 0xeb3e4975 },
+    { 0x8a2979a9, 0x60e16970, 0x8b01ce7b, 0xc9d1ce32 },
+    { 0xd4fd7b86, 0x57b8e99a, 0x3853473d, 0xee6262e1 },
+    { 0x7f0861fd, 0xa1ea4d71, 0xa2327f56, 0x668140b3 },
+    { 0x08a24926, 0x2fb44195, 0x6d916ade, 0x4e271317 },
+    { 0xd35f6af2, 0x4677800b, 0x7b28f619, 0x83bc62cd },
+    { 0x0dfcd277, 0x46325cc0, 0x73a74986, 0x19b1cec2 },
+    { 0xb8c5a6a6, 0x97e03957, 0xba0dcd4f, 0xee16f96c },
+    { 0x584b12af, 0x7316a7cd, 0x7a2ba910, 0x53fe0a37 },
+    { 0x08b50aa9, 0x78f5b997, 0xb6319395, 0x665aaf09 },
+    { 0x2d6021ee, 0x4f64a1a4, 0x0baac402, 0x14dbe352 },
+    { 0xff5111ed, 0x8cdd10af, 0x9596864e, 0x7584f641 },
+    { 0x2e4b8d20, 0x6c4fa858, 0x60a23f97, 0x6cbdae97 },
+    { 0x8fd0c1ad, 0x8d6d396c, 0x1b2a88a9, 0x5409d06c },
+    { 0x070bbd82, 0x38dc68d8, 0xe2f8cff2, 0x1a377633 },
+    { 0xdeef0ad1, 0x306d9b7b, 0x75f46cc6, 0x6ea3c8e6 },
+    { 0x3b11252c, 0x1849dfcf, 0x83608b0c, 0x4271354c },
+    { 0x7bc67b5d, 0x699cac0a, 0xd888887f, 0x88e6db6e },
+    { 0xdc16b5e8, 0x2514ba92, 0x5de9763f, 0x11534240 },
+    { 0x19a6c40d, 0xfdd2110d, 0x9499febc, 0x686d0878 },
+    { 0xf7afe108, 0xf3be07b8, 0x730b948d, 0x0f8aed94 },
+    { 0xf460532d, 0xc59fb123, 0xa69c31b0, 0x5322c76e },
+    { 0x51e478c4, 0xf5e2f2d7, 0xfe9852d5, 0x95e92935 },
+    { 0xb50d1e24, 0xb42d61cd, 0xbd400cdd, 0x09d372b1 },
+    { 0x6bdfad84, 0xc4c77b39, 0x2c1d0568, 0xe7536e87 },
+    { 0x1971c861, 0x9b2f7d00, 0x5bfabd1e, 0x4b9d0a59 },
+    { 0xfa529189, 0x29d8e7c8, 0x6e84af09, 0xd61683d9 },
+    { 0xafa34e18, 0x990b180c, 0x93d1a9a8, 0x2bddc822 },
+    { 0x4690ac90, 0x83f99607, 0x720d8d54, 0x8c913c7b },
+    { 0x369ee447, 0xb2090283, 0x4e01096b, 0x5bcc6a1a },
+    { 0x5bdef343, 0x1b6400d1, 0xe94b6db2, 0x789925e5 },
+    { 0x24768a59, 0x298bd3d0, 0x17709585, 0x44b170cf },
+    { 0x5d874f1b, 0x170214ce, 0x0b14099d, 0x97cda294 },
+    { 0xe0d94af5, 0x53f78198, 0xf13a78ac, 0x48731cb9 },
+    { 0xccca1be5, 0xa64a2fb8, 0xe4558a6e, 0x3f16f673 },
+    { 0x0683f257, 0x6dd6ee27, 0x99a8d18e, 0xa3ef88df },
+    { 0xcb56667c, 0x87a4583d, 0xdec5bb9a, 0xdeaa4ca2 },
+    { 0xcfa23a11, 0xf03580b0, 0x76e2536b, 0x8c8fab83 },
+    { 0xb6ff34b1, 0x16f8a8c8, 0x445b421d, 0x6157c701 },
+    { 0x4ec6d5de, 0x4cf8b920, 0x7e968b3e, 0xc9790225 },
+    { 0x35a81e7c, 0x3b0ce3bf, 0xc4c741e4, 0xdbcbeaae },
+    { 0x816402f4, 0x1970e372, 0x8b80bd92, 0x479e43a8 },
+    { 0xddeca818, 0xc45c3501, 0x2253cc65, 0x0adcea84 },
+    { 0x729a959b, 0x880a3b77, 0x4de1459a, 0xb1afc783 },
+    { 0x61fb9420, 0xe6895754, 0x2f656668, 0x5d351d8e },
+    { 0x09e626b1, 0xed521e9b, 0x48307882, 0x1f945c5f },
+    { 0x7e887a38, 0x6247b9b1, 0xab5076c6, 0x8f5e8e11 },
+    { 0xc815942d, 0x3bef9fbe, 0x163b81db, 0xdd9db375 },
+    { 0x556b1be1, 0x570b130f, 0xef247f68, 0x81a138ad },
+    { 0x744853a3, 0x485c1e3e, 0xae1e2311, 0x2ca9fb49 },
+    { 0x1615188d, 0x821fd395, 0xf2c0b4f8, 0x3e3e7fb3 },
+    { 0xfbb4ea2a, 0x0c437163, 0xeeeeff2f, 0xce994be3 }
+};
+
+constexpr static const uint64_t JUMP_POW2_X512PP[64][8] = {
+    { 0x0000000000000002, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000004, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000010, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000100, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000010000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000100000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000000, 0x0000000000000001, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000000, 0x0000000000000000, 0x0000000000000001, 0x0000000000000000,
+      0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+      0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+    { 0xcf3cff0c00000001, 0x7fdc78d886f00c63, 0xf05e63fca6d7b781, 0x7a67058e7bbab6f0,
+      0xf11eef832e32518f, 0x51ba7c47edc758ad, 0x8f2d27268ce4b20b, 0x0000500055d8b77f },
+    { 0x1562552281c990bd, 0xab04eab276c94cd4, 0x766c24eb5d1ab503, 0x65aa580218f714bf,
+      0x401016a49f96c88f, 0x7e008dd3ce077884, 0x958292592b0e9a05, 0x8261439092fc4bea },
+    { 0x436ca30b0af2fbee, 0x4e803f8cd3ee43e7, 0xcab624d586163076, 0x3c1083d99ff7c0df,
+      0xb3c177a70a89a744, 0xab77fc0da20ee366, 0xe1a558eb71b583b9, 0x0338601cc05215bc },
+    { 0x3d60fd534f9ed4d7, 0x24b31127edf08cbc, 0x3d893738e2adbd9f, 0x248b5c7c810d3a8f,
+      0x7cb50d47032f8fb6, 0xf3a4c9f2477d5ff3, 0x56760a0096818893, 0x1fc11ddfa0d99e75 },
+    { 0xbf122824333d75f7, 0x98c9dec62fe1c711, 0x935155c12eaf3238, 0xdefba0978be327fe,
+      0xbfb6e4223bbf46ef, 0x1d69cfa59880acb7, 0x3cb005e391cc9068, 0x9eae24bb84eb9f94 },
+    { 0x73a0f5b80f363281, 0x97c5416b2c434275, 0xc8db93e4845102f3, 0x0c2b68e7206abfeb,
+      0x2aaad11940d7f715, 0x53c1ce3f1bba1173, 0x38b5369c250f7d3b, 0x206c4f1a6f328b28 },
+    { 0xf8e0c5adf992f78e, 0xc6ee29c020af3625, 0xb3938b69aa594725, 0x3d49f67f8720f3c3,
+      0x400a4573c9aac0c1, 0x8a302be53db7fc39, 0x841826c5b3811ff3, 0x862e4ab6054bff8d },
+    { 0x3d96a5f67b544b01, 0xed1329c6a4070e53, 0x12990bf72e92851e, 0x6d09b79c36d62b2f,
+      0x4190b88dd2af5806, 0xde92a62cf9b6e481, 0xf07d188da9aded5b, 0x1f45f1c244710ce1 },
+    { 0x77105be3daf2447b, 0x2af714657c8a8f7d, 0xef248e01d259c45e, 0x6b6f85ba688be685,
+      0xc43e30f4d2a228ac, 0x0474775257c42ff1, 0x1fc57edc8a7658db, 0xaeb69c0a80ff82c7 },
+    { 0xa3b52cd7ea7228fe, 0x63ce35c7e79496d5, 0x724b229f008d24f2, 0xaea270af1d932b6f,
+      0xe70416adc805e3c4, 0x4c8efb93d4b2bdeb, 0xa7bdfd886a4f3fa2, 0xef8bb165bc98cf09 },
+    { 0x1fd7ee682e4b1aef, 0xe2a5e732d80c7a4c, 0xf8047a65788b8f6e, 0xacf54735c76679bd,
+      0x02931b16066e5ff7, 0x1f56c0ae3d53f7ff, 0xd7051bdcb7a6503f, 0xb612acc6e4ba6a99 },
+    { 0xd3ebf59b1070cbe7, 0xdb4907cd4afb4ff2, 0x48c806353314b086, 0xa44f5bd4b6449c12,
+      0x2f1c70846bef3e7c, 0x840b2fc0e82821d1, 0x19f2e0ae40f32a75, 0xb0e0b0729aee9ca2 },
+    { 0x89eaff798742dd9b, 0x373ec51145874fa7, 0xfc767023d730ffc5, 0x46f2f8a160fb618d,
+      0xc8d1e5b2ba213ec3, 0x75f9cf15a88c4be1, 0x1ab66225bd594873, 0x23bfff1c81a3a2a7 },
+    { 0x21bd082593d91d0f, 0x2fabaa4eb14fa680, 0xb12d14ec50afcdff, 0x1cb03638340d036a,
+      0x15850d7103740ab6, 0x0fc476d2f2058bda, 0x403d781a26b8d91f, 0x63a517d081053bb0 },
+    { 0xc64a894e78bd5001, 0xd02547e23c4754bb, 0x4dffd806b0c26af6, 0x79658acd11e429bb,
+      0x78cd3f40eccd6aa7, 0x6f2125ae70794d1f, 0x197c6488bba24176, 0xed9638dc136aff77 },
+    { 0xb5c1bedee7853b9a, 0xdbf2cd74e89a7dec, 0x0a6f274db0844630, 0x43233209082c0670,
+      0x784a35974edbd941, 0x508a187a6c1721b3, 0x1eccf58de53410bf, 0xdf9e0d29e7053230 },
+    { 0x55bdddc85ffb8447, 0x29f5850e29ff5154, 0xb319cbe83cb809f8, 0x4e0699c1e0e40678,
+      0xa9a5bbdc5ddc9a19, 0xab22a144f675dff9, 0x27f9ebab27dbb3dd, 0xbf0707a70a21a013 },
+    { 0x4686ed8f1939e75a, 0x448d366a629b4307, 0x11d5e03912a8320a, 0x882f8e071d6d370c,
+      0x11e92c584a632081, 0x6b15562caafcddeb, 0x4c36f49c31e27043, 0xcd7eebe84f323a13 },
+    { 0x002a62fd6cbf31d0, 0x7ab9e0bb2955b713, 0xb786699a082e225b, 0xdf65bc5fb27ba790,
+      0x8eae861a8c691880, 0xfea77073ae25d96e, 0xb74291b344277e48, 0x65aac53506166925 },
+    { 0xc25e4bb99d1db63d, 0x599e4d9cfb762bcb, 0x16a90764ef406b90, 0xc23a0a563ffc59d2,
+      0x6591107c737d07ce, 0x302b7c79f0d10c4f, 0xc4a6686e733c2aec, 0xbafd2569594b33ea },
+    { 0x69aad7235d9f7b03, 0x0ae5a4b24a714516, 0x06c8747a8976bb90, 0xbfb0640f0859719f,
+      0x9bcc8c1c0513bcca, 0x7c197efb11dcb502, 0x0949a4ddd3940ea8, 0x3f80b55c1e92ab06 },
+    { 0xb9b7b3e8eb1297c8, 0x461403ea8500540a, 0x1027f26cf3abd64c, 0x8ab2e5be8064bb6c,
+      0x1e5915f577e26bca, 0xafb5c2c98da7f348, 0x9285b67aa5d1366e, 0xa6bfc461ed34a1cc },
+    { 0xefea335926a6af96, 0x10c90451dc956158, 0x0eecf5d447aec3f7, 0x76609cc4ebf09115,
+      0x146ac25125363c5f, 0x64bf0423bf0c828a, 0x5c760db9568a8a8f, 0x2f0b3e8224dcc296 },
+    { 0x18587e0ed4e7026e, 0xcfb2c59a17a592d9, 0x937d6ff4e373df9f, 0x4cd76c9dcf183c6c,
+      0x371b5582ae2acff1, 0xf265c755b171fd8e, 0x5c01eaa035e14907, 0x4bc4a81d8546c20d },
+    { 0x1c3c69cb6634cfda, 0xa5ea62f6a45b4079, 0xa4d3443d00b09cab, 0x7938b222ed48d6fc,
+      0x71e526c2c4d67451, 0xc7078694ae4615e7, 0x5ae9c51b9d853b7a, 0x6769bc5ef8fde8c9 },
+    { 0xe11a42c633213d72, 0x02a42caa6c3f5842, 0x24497a6366558780, 0x350fb283cc704585,
+      0x388d6dc39e67e541, 0x7f60fc8d4e8bf541, 0xfdf25902cb1a4e09, 0xfb4bb5f311e0573f },
+    { 0x1a845b7c88faad35, 0x72b7af4d5f325f0b, 0xb3de68da747aacd5, 0x0f198dee1e421532,
+      0x0fd135f7b7aee914, 0x76b4dd4ba1da7fe2, 0x343cc853fbc56578, 0xc9b100ff0f62e43f },
+    { 0x97e0ebe8958d0115, 0xc64aefec3ca3f49d, 0x7b097aaab092f25e, 0xc01d0cb16b8beea4,
+      0xc66120f2eab8beaf, 0x4c59ac7515415467, 0x79885ce30ffad2ea, 0x80a7f1eb12faa8cc },
+    { 0xad657b2273c51122, 0x89cecc173c47e337, 0x64e254667adb6c9e, 0x02ba494fec0b569b,
+      0x01ae9488e87fdd19, 0x1b83e57385a52b38, 0xbbec1915e6819368, 0x3e03cf5e7cb7d7f2 },
+    { 0x79c9acec53786b88, 0x72fbf434ee13d59a, 0x47996812ba757468, 0xed984ee8f92e578d,
+      0x6dd310908c074212, 0x90401e58cb9ad7be, 0xd3676c320835b553, 0xa1caaf37e98cd491 },
+    { 0xbb94694e206857f8, 0x5970c96027c3cc07, 0x4500e6af8e909bf1, 0x45ce99304f82f84a,
+      0x6b9b49b2ed974c5c, 0x130e694ec78275ea, 0x1e86b552f439a3e3, 0x910fd4408a0165cc },
+    { 0xac9c8abfcb89f65f, 0xe42e8dff1c46de8b, 0x63f6ec277fd3d303, 0xb0f7cd5a8d78058e,
+      0x06e13e5e8c92c843, 0xf92e8346feee7a21, 0x784df3e2088b8db9, 0x14420331573cc2a6 },
+    { 0x8d18dddd187f31c5, 0xcaac9715b86e0b96, 0xc41083c782e74c07, 0x8d2f504df88f46e0,
+      0x905be8b2a91fc69b, 0x93a859109d468a3c, 0x507ac99671e612df, 0x6de4cd190ccd3613 },
+    { 0x8e8ef5b0b201e220, 0xb9adec021dee8a2a, 0xce4ce76ee6300756, 0xb08cd8c5b724f3cf,
+      0xb08efd0b81ee9e78, 0x735dfa5b5b9a3ef7, 0x8ba69875e548a306, 0xea7c431fa1aba53a },
+    { 0xf433ed41f99c58b6, 0x1d462282e7ac9ee2, 0xd8054d34de9afec9, 0xb031b6d4efdc3bb1,
+      0xd46bac385a99c4c9, 0x666bf6655123117f, 0xbf74193252370e54, 0x6d055f6a328dd2d4 },
+    { 0x06eb1d14bccc9178, 0x63112c2ebf836255, 0x7363a47035f031dc, 0xc06c0260eeea9bd2,
+      0x852a39652feaa4f2, 0xbb98be27a65e87c3, 0x67f83a2a8f936088, 0x2e69feb0c38fd21c },
+    { 0xaedb768665d26f06, 0x34bfe3d7017fbb15, 0xcdb86fedcca8c7a1, 0x16d5d1a4c13f5df3,
+      0x7402ed44559ca885, 0x847bf0a201f359f2, 0xc0be626bcc945643, 0x7c32689b54c1e42e },
+    { 0xd9a8696dc302b341, 0xdc9759cfa4b656f8, 0xb946afafcde489cd, 0xf69a44148460d9e7,
+      0x96d37066de37aadb, 0x09ab44207f61b359, 0xe5ef211413d7433a, 0x0cc3e4d5eaa9c6be },
+    { 0x0b153d4d286fd343, 0xd5906fd1f1a983ae, 0x300528635345ca82, 0xa193133a77452114,
+      0xd8d033fa51a49f2f, 0x149efa4a48b976f6, 0x8019d715d0b570b3, 0x7e2c3ecd349b5361 },
+    { 0x08958658958ca33f, 0xe4c5a8880cf02295, 0x55b14f2578556fe5, 0x9890b3a1c8935134,
+      0x96c270272cf41807, 0x2ead9e6150f7d960, 0x97b44ef421417311, 0xa48cf07b146bca55 },
+    { 0x731e9a58a851e872, 0x079b6fffb8429d54, 0x5ad1b0b9e1b8097d, 0xd1eb8bf99b1dfe98,
+      0x9b3c3bc00dc713fe, 0x88eac5c39a152b89, 0x5981c09eed4c1ce2, 0x6e4ea6b4ddcb8278 },
+    { 0x22f986937a8aa3da, 0x6067155bcced2e74, 0xbc87f32c24ed905d, 0x53791d2f2c5b3152,
+      0xe00bece15bd5d59f, 0xc56e6f7671acf21e, 0xec3bf9bbc7a8ba71, 0x51e7cd7306bdad3d },
+    { 0x0132d9c175b93e23, 0xfc2329a009a6fd8c, 0x50019122b9b1a3f6, 0x977f2c62264c12bf,
+      0x5997112709a8fb26, 0x367e2e3720903fab, 0xa4ebd243d4235672, 0x39cfd8095c1f7b60 },
+    { 0x6e2bf58cbfb358bd, 0xf148e8023193cad7, 0x319b432749f41a82, 0x865a89b1542d2012,
+      0xc943a5750b1ebfc0, 0xc98393862dc6b3a7, 0xae800b8d3ca1b7f5, 0x2bce3e6edfc8dfef },
+    { 0x374ae13e3f0841a4, 0xac0f01c406648684, 0x0e6e7430044a89de, 0xb0d25c5311eff639,
+      0x90a314ffca8ad200, 0x9f17ff82a0e02211, 0x4c1242216e735825, 0x1be9ce405652cbfa },
+    { 0xf86ca2a8873a4aec, 0xa1b4775eb81184d0, 0xec42c5b5d17282ae, 0xc5e33788b3c15bab,
+      0x2a42cdc9b765d541, 0x0ab2a4e08ff86cf0, 0x396f721c46ba7946, 0x9cae606fa82b3610 },
+    { 0x41b6631d5b61d665, 0x80c38cfaa6228d8e, 0xe909f70f17d19ea2, 0x84d6a4f2c23cf452,
+      0x73c68f276685114a, 0xf2e9cedc668c1e31, 0x0a341daca950b2f8, 0xfc7636ffa1d90947 },
+    { 0xed586fb3e88d549a, 0xe771236f2c0047b1, 0xf72ad65b7b6e4764, 0x1886986edae3de6f,
+      0xd755bd395d621ba3, 0x6a5ad7b054fc394f, 0x84029200d20ac9b2, 0xfa0c42ab0c36cd27 },
+    { 0xb6ee5b9881a0d380, 0x358122499dfaaa78, 0x5f1c7c2fb3c160c9, 0x74f0ca8fd6722754,
+      0xbfdafcbdf2ae0074, 0x03d66e6d92d70cc0, 0x668aba7aea0016d9, 0x5f8525b4c85f61a7 },
+    { 0x84ca7ff9fbcf8285, 0xf29e8763831c264f, 0xf80cc89c4a505651, 0x0ae15b899644d7e2,
+      0x8bedaa22aeb8b913, 0xf3e68232e68ed3c9, 0xac2b6792eb71ff61, 0x7edb4418d8f31b3b },
+    { 0x308d1faf796acca4, 0x2a1c7c4083d93078, 0x7fc9207821667c5d, 0xb0eb6f53972b0107,
+      0xf4d7d8ca1182022e, 0x48848d545f50f627, 0xaf8293fb03dbe72e, 0xc5f0081793b1e89b },
+    { 0x6b92617a2f662708, 0x0a9508156b1217e5, 0x448a415980b13057, 0x6f311e01e67f16a6,
+      0x39f422d46abada9e, 0x3bb9b4e0609d99fb, 0xd7a0ce954eb066e1, 0x11ed7cf5c5c5dec4 },
+    { 0x448b4b1658fe793b, 0xb96f0fc95c46eb3d, 0xd393a1b9e6978633, 0xec9ad2b8c8067a32,
+      0x1f97f71dba1977e4, 0x047b608ff09e3b2c, 0xf802c8b85f65e57b, 0x01c0d1f4942955ef },
+    { 0x861c8bfb0b536331, 0x27e6b5caa847d05a, 0x6bebb076a3500db3, 0x422e6c4756c57ef4,
+      0x0c5798a4f75addaa, 0x808e2cdf378d4596, 0x8a8b71f8d8c88cb8, 0xb04667457d190c28 },
+    { 0x5bdb738fa13223ea, 0x6177199056e224ba, 0x7a433ba6fcd93177, 0x1e3e94c50b5a8e0d,
+      0x373f793abb2dbc7f, 0x4f5b52a58ceb9afd, 0x44ba4b256a0f306c, 0x77ed7dec0212c5c8 }
+};
+
+constexpr static const uint64_t JUMP_POW2_XORO128PP[64][2] = {
+    { 0x0000000000000002, 0x0000000000000000 },
+    { 0x0000000000000004, 0x0000000000000000 },
+    { 0x0000000000000010, 0x0000000000000000 },
+    { 0x0000000000000100, 0x0000000000000000 },
+    { 0x0000000000010000, 0x0000000000000000 },
+    { 0x0000000100000000, 0x0000000000000000 },
+    { 0x0000000000000000, 0x0000000000000001 },
+    { 0x8dae70779760b081, 0x0031bcf2f855d6e5 },
+    { 0x698449945af6e210, 0x76b6b675b4399be5 },
+    { 0x9dc079f856627b49, 0x5454b06c8eed86e5 },
+    { 0x165cc1e18698ffdc, 0xe956a4fe5daba959 },
+    { 0x987821353a7a6a8c, 0x9918f90f4de84d54 },
+    { 0x8fce38ba75aeae64, 0xfbf69397a87403c9 },
+    { 0xb31e81db3c05a619, 0xd78f10584ea0d82f },
+    { 0x8fa1fe2055b437b6, 0x6fef003cf608f215 },
+    { 0x1fa02cf78f2fdd17, 0x7651f43bbc7eb2cf },
+    { 0x827d13a11a5bfa45, 0x24494f690e559f39 },
+    { 0x2abc0fd67da91dd9, 0x04740afdac8489b6 },
+    { 0x6606bd124e18c8a9, 0x60a51822e8236e81 },
+    { 0xf5f9539dc71ac3ab, 0xd75b8968c7ceca4e },
+    { 0x6b4baffcf30dec89, 0x7e856d55a389667f },
+    { 0xe5bfcec2f359c7a8, 0xa5bcffe4053a6102 },
+    { 0xa89aedb5a5745c5e, 0x2fde12e83fed0371 },
+    { 0x54f8e8a35e6751a8, 0x200a7abb7ee6b6ad },
+    { 0x8d5830a397139bd9, 0x6cd6c45648fc0bd1 },
+    { 0x1aea99285ae82a25, 0xc09899748cb8714d },
+    { 0xc33764e2b4b496d4, 0x8bbac46728f233e6 },
+    { 0x96a83a9b997356cd, 0x93e0557620543a4a },
+    { 0x0432b5b118309ab1, 0x4b124c565024b68f },
+    { 0xad428ecc2d1df942, 0x8214852b2e7d8d52 },
+    { 0x36e5cedab942bebb, 0x2a52709ab1323f09 },
+    { 0xf840354cc7729590, 0x546cf3a2e65eb617 },
+    { 0xfcceec21d5c306d9, 0x2e1bcf52f1051044 },
+    { 0xaf2b647b6fae2f5d, 0xc5e96f1068c53dc7 },
+    { 0x3301ebe70c293cf1, 0x6b33331e56a0409a },
+    { 0x34449640a2de9ee0, 0x4e1697c372fe2e09 },
+    { 0xd68291c59a0039e6, 0x65952eb7223f45d7 },
+    { 0x89047b77bdb72952, 0xf5776067d400cd50 },
+    { 0xd9de469cd9b426a3, 0x7064347eeb843e29 },
+    { 0x1c1ce5f1d724e8b0, 0x97d4f2f61686db42 },
+    { 0x48626fce7e14a96a, 0x91a9950421613b7e },
+    { 0xff9e40e62707684a, 0x6d9a8da7167ddfcf },
+    { 0x7153f907d99d986e, 0x64d9e04e6c1884cd },
+    { 0x106b225bd03a7779, 0x34999078aabaffe8 },
+    { 0x171de3b3151294c3, 0x6f34444d79a4141d },
+    { 0x021b7ab2d80bf6d3, 0x07a6abea7a39f53a },
+    { 0xe305be89cf8864c3, 0x316ffb2dbaee1f80 },
+    { 0xc454160b2f7531e9, 0xe3d82f661909d35f },
+    { 0x99030a888c867939, 0xc8462a08ab3d7f9b },
+    { 0xb00e87f3cad5557a, 0xc224a2e0618cf653 },
+    { 0x7fcbb32c64535326, 0xb26b1479a2f015ed },
+    { 0x4603f11781a272a8, 0x5a6ea25958c39caf },
+    { 0x31e021743866ff76, 0x98958a5c93a79430 },
+    { 0x02e49b03803828d2, 0x0d70f123179c9fc1 },
+    { 0x10b744b13b716efe, 0xa134840f1fa881a1 },
+    { 0x67acc043b986e7a8, 0x8715ba98f99b61a1 },
+    { 0x53fbec60192e2e25, 0xf7fbb2e37725a509 },
+    { 0xc2b1fed493340f96, 0x191de3ce06c2fd40 },
+    { 0xfdfe1293f3cccdda, 0x5ab69d0781713e3e },
+    { 0x6efbf3eb53faf165, 0x33c379c988647c4e },
+    { 0x0599551d5fd1d519, 0x98e6f5415bb0f982 },
+    { 0xa3cab09016ea1495, 0xd0d2b2c0186af373 },
+    { 0x8ff5a00c3ab6f5ea, 0x4dac0402699531ac },
+    { 0x86b9d90f55fae014, 0x7107f7bfbb111c61 }
+};
+
+/* Characteristic polynomials of the linear engines, without the leading term
+   (x^n for an n-bit state), in the same bit layout as the jump tables. */
+constexpr static const uint64_t CHARPOLY_X256PP[] = { 0x9d116f2bb0f0f001, 0x0280002bcefd1a5e, 0x04b4edcf26259f85, 0x0003c03c3f3ecb19 };
+
+constexpr static const uint32_t CHARPOLY_X128PP[] = { 0xde18fc01, 0x1b489db6, 0x006254b1, 0x00fc65a2 };
+
+constexpr static const uint64_t CHARPOLY_X512PP[] = {
+    0xcf3cff0c00000001, 0x7fdc78d886f00c63, 0xf05e63fca6d7b781, 0x7a67058e7bbab6f0,
+    0xf11eef832e32518f, 0x51ba7c47edc758ad, 0x8f2d27268ce4b20b, 0x0000500055d8b77f
+};
+
+constexpr static const uint64_t CHARPOLY_XORO128PP[] = { 0x8dae70779760b081, 0x0031bcf2f855d6e5 };
+
+/* 'discard' steps through the lowest bits of its argument one by one and jumps for the rest */
+constexpr static const int DISCARD_LOOP_BITS = 8;
+
+/* Replaces the state of 'rng' by the sum (XOR) of the states it would go
+   through, taking the steps whose bits are set in 'jump_table'. This is done
+   with masks rather than branches, and only the state transition of the
+   engine is computed, on local copies of the state words. */
+template <class int_t, class rng_t>
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void jump_state(const int_t jump_table[], rng_t &rng)
+{
+    constexpr int n_words = rng_t::state_words;
+    int_t s[n_words] = {};
+    int_t acc[n_words] = {};
+    for (int w = 0; w < n_words; w++)
+    {
+        s[w] = rng.state[w];
+        acc[w] = 0;
+    }
+    for (int i = 0; i < n_words; i++)
+    {
+        int_t bits = jump_table[i];
+        for (int b = 0; b < 8*static_cast<int>(sizeof(int_t)); b++, bits >>= 1)
+        {
+            const int_t mask = static_cast<int_t>(0) - (bits & 1);
+            XOSHIRO_UNROLL
+            for (int w = 0; w < n_words; w++)
+                acc[w] ^= s[w] & mask;
+            rng_t::step(s);
+        }
+    }
+    for (int w = 0; w < n_words; w++)
+        rng.state[w] = acc[w];
+}
+
+/* Polynomial over GF(2) of degree lower than the size of an 'n_words'-word
+   state, with the coefficient of x^j in bit j%B of word j/B (B being the
+   number of bits in 'int_t'), which is the layout of the jump tables above.
+   Jumping with the polynomial x^d reduced modulo the characteristic
+   polynomial of the generator advances it by 'd' steps, so computing one such
+   polynomial once and keeping it around makes every subsequent jump by the
+   same distance cost a single pass of 'jump_state'. */
+template <class int_t, int n_words = 4>
+struct JumpPolynomial
+{
+    int_t coef[n_words];
+};
+
+/* Bytes in the vector registers that the batched functions below work with. */
+#if defined(__AVX512F__)
+constexpr static const int VECTOR_BYTES = 64;
+#elif defined(__AVX2__)
+constexpr static const int VECTOR_BYTES = 32;
+#else
+constexpr static const int VECTOR_BYTES = 16;
+#endif
+
+/* Applies 'jump_state' to 'n' generators at once, in groups that are advanced
+   together as the lanes of 'LaneVector's. 'polys' and 'poly_stride' select
+   the polynomial for each generator: generator 'i' is jumped with
+   'polys[i*poly_stride]', so a stride of zero uses the same one for all of
+   them. */
+template <class int_t, int n_words, class rng_t>
+static inline void jump_state_batch(const JumpPolynomial<int_t, n_words> *polys, const std::size_t poly_stride,
+                                    rng_t *rngs, const std::size_t n)
+{
+    static_assert(n_words == rng_t::state_words, "polynomial does not match the generator");
+    constexpr int W = VECTOR_BYTES / static_cast<int>(sizeof(int_t));
+    using vector_type = LaneVector<int_t, W>;
+    for (std::size_t start = 0; start < n; start += W)
+    {
+        const int n_group = static_cast<int>((n - start < static_cast<std::size_t>(W))? (n - start) : W);
+        int_t words[n_words][W];
+        const int_t *tables[W];
+        for (int lane = 0; lane < W; lane++)
+        {
+            const std::size_t ix = start + static_cast<std::size_t>((lane < n_group)? lane : 0);
+            tables[lane] = polys[ix * poly_stride].coef;
+            for (int w = 0; w < n_words; w++)
+                words[w][lane] = rngs[ix].state[w];
+        }
+        vector_type s[n_words];
+        vector_type acc[n_words];
+        for (int w = 0; w < n_words; w++)
+        {
+            s[w] = vector_type::load(words[w]);
+            acc[w] = vector_type::broadcast(0);
+        }
+        for (int i = 0; i < n_words; i++)
+        {
+            for (int b = 0; b < 8*static_cast<int>(sizeof(int_t)); b++)
+            {
+                vector_type mask;
+                if (!poly_stride)
+                {
+                    mask = vector_type::broadcast(static_cast<int_t>(0) - ((tables[0][i] >> b) & 1));
+                }
+                else
+                {
+                    int_t masks[W];
+                    for (int lane = 0; lane < W; lane++)
+                        masks[lane] = static_cast<int_t>(0) - ((tables[lane][i] >> b) & 1);
+                    mask = vector_type::load(masks);
+                }
+                XOSHIRO_UNROLL
+                for (int w = 0; w < n_words; w++)
+                    acc[w] ^= s[w] & mask;
+                rng_t::step(s);
+            }
+        }
+        for (int w = 0; w < n_words; w++)
+            acc[w].store(words[w]);
+        for (int lane = 0; lane < n_group; lane++)
+            for (int w = 0; w < n_words; w++)
+                rngs[start + lane].state[w] = words[w][lane];
+    }
+}
+
+/* Jumps each of the generators in [rngs, rngs+n) with the same table. */
+template <class int_t, class rng_t>
+static inline void jump_state_many(const int_t jump_table[], rng_t *rngs, const std::size_t n)
+{
+    JumpPolynomial<int_t, rng_t::state_words> poly;
+    std::memcpy(poly.coef, jump_table, sizeof(poly.coef));
+    jump_state_batch(&poly, 0, rngs, n);
+}
+
+/* Jumps generator 'rngs[i]' with polynomial 'polys[i]', for i in [0, n). */
+template <class int_t, int n_words, class rng_t>
+static inline void jump_state_many(const JumpPolynomial<int_t, n_words> *polys, rng_t *rngs, const std::size_t n)
+{
+    jump_state_batch(polys, 1, rngs, n);
+}
+
+/* p <- p*x mod charpoly */
+template <class int_t, int n_words>
+XOSHIRO_CONSTEXPR static inline void poly_times_x(int_t (&p)[n_words], const int_t charpoly[])
+{
+    const int n_bits = 8*static_cast<int>(sizeof(int_t));
+    const int_t mask = static_cast<int_t>(0) - (p[n_words-1] >> (n_bits - 1));
+    XOSHIRO_UNROLL
+    for (int i = n_words - 1; i > 0; i--)
+        p[i] = (p[i] << 1) | (p[i-1] >> (n_bits - 1));
+    p[0] = p[0] << 1;
+    XOSHIRO_UNROLL
+    for (int i = 0; i < n_words; i++)
+        p[i] ^= charpoly[i] & mask;
+}
+
+/* a*b mod charpoly */
+template <class int_t, int n_words>
+XOSHIRO_CONSTEXPR static inline JumpPolynomial<int_t, n_words> poly_mulmod(const JumpPolynomial<int_t, n_words> &a,
+                                                         const JumpPolynomial<int_t, n_words> &b,
+                                                         const int_t charpoly[])
+{
+    JumpPolynomial<int_t, n_words> out = {{0}};
+    for (int i = n_words - 1; i >= 0; i--)
+    {
+        for (int bit = 8*static_cast<int>(sizeof(int_t)) - 1; bit >= 0; bit--)
+        {
+            poly_times_x(out.coef, charpoly);
+            const int_t mask = static_cast<int_t>(0) - ((b.coef[i] >> bit) & 1);
+            XOSHIRO_UNROLL
+            for (int w = 0; w < n_words; w++)
+                out.coef[w] ^= a.coef[w] & mask;
+        }
+    }
+    return out;
+}
+
+/* base^(hi*2^64 + lo) mod charpoly */
+template <class int_t, int n_words>
+XOSHIRO_CONSTEXPR static inline JumpPolynomial<int_t, n_words> poly_powmod(JumpPolynomial<int_t, n_words> base,
+                                                         std::uint64_t lo, std::uint64_t hi,
+                                                         const int_t charpoly[])
+{
+    JumpPolynomial<int_t, n_words> out = {{1}};
+    for (int half = 0; half < 2; half++)
+    {
+        std::uint64_t exponent = half? hi : lo;
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (!exponent && (half || !hi)) return out;
+            if (exponent & 1) out = poly_mulmod(out, base, charpoly);
+            base = poly_mulmod(base, base, charpoly);
+            exponent >>= 1;
+        }
+    }
+    return out;
+}
+
+/* x^(hi*2^64 + lo) mod charpoly, taking the powers x^(2^k), k < 64, from 'pow2_table' */
+template <class int_t, int n_words>
+XOSHIRO_CONSTEXPR static inline JumpPolynomial<int_t, n_words> jump_polynomial_for_distance(const std::uint64_t lo, const std::uint64_t hi,
+                                                                          const int_t (*pow2_table)[n_words],
+                                                                          const int_t charpoly[])
+{
+    JumpPolynomial<int_t, n_words> out = {{1}};
+    for (int bit = 0; bit < 64; bit++)
+    {
+        if ((lo >> bit) & 1)
+        {
+            JumpPolynomial<int_t, n_words> factor = {{0}};
+            for (int w = 0; w < n_words; w++)
+                factor.coef[w] = pow2_table[bit][w];
+            out = poly_mulmod(out, factor, charpoly);
+        }
+    }
+    if (hi)
+    {
+        JumpPolynomial<int_t, n_words> x64 = {{0}};
+        for (int w = 0; w < n_words; w++)
+            x64.coef[w] = pow2_table[63][w];
+        x64 = poly_mulmod(x64, x64, charpoly);
+        out = poly_mulmod(out, poly_powmod(x64, hi, 0, charpoly), charpoly);
+    }
+    return out;
+}
+
+/* This is a fixed-increment version of Java 8's SplittableRandom generator
+   See http://dx.doi.org/10.1145/2714064.2660195 and
+   http://docs.oracle.com/javase/8/docs/api/java/util/SplittableRandom.html
+
+   It is a very fast generator passing BigCrush, and it can be useful if
+   for some reason you absolutely want 64 bits of state. */
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline std::uint64_t splitmix64(const std::uint64_t seed)
+{
+    std::uint64_t z = (seed + 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+/* State transitions of the generators, as functions of the state words 's'
+   (either plain words or 'LaneVector's of them), templated on the shift and
+   rotation constants. The output functions (scramblers) below are applied to
+   the state before the transition. */
+template <int A, int B>
+struct XoshiroTransition4
+{
+    constexpr static const int state_words = 4;
+
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void advance(word_t s[4])
+    {
+        const word_t t = s[1] << A;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl<B>(s[3]);
+    }
+};
+
+template <int A, int B>
+struct XoshiroTransition8
+{
+    constexpr static const int state_words = 8;
+
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void advance(word_t s[8])
+    {
+        const word_t t = s[1] << A;
+        s[2] ^= s[0];
+        s[5] ^= s[1];
+        s[1] ^= s[2];
+        s[7] ^= s[3];
+        s[3] ^= s[4];
+        s[4] ^= s[5];
+        s[0] ^= s[6];
+        s[6] ^= s[7];
+        s[6] ^= t;
+        s[7] = rotl<B>(s[7]);
+    }
+};
+
+template <int A, int B, int C>
+struct XoroshiroTransition2
+{
+    constexpr static const int state_words = 2;
+
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void advance(word_t s[2])
+    {
+        const word_t s0 = s[0];
+        const word_t s1 = s[1] ^ s0;
+        s[0] = rotl<A>(s0) ^ s1 ^ (s1 << B);
+        s[1] = rotl<C>(s1);
+    }
+};
+
+/* rotl(s[I] + s[J], R) + s[I] */
+template <int I, int J, int R>
+struct ScramblerPlusPlus
+{
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline word_t output(const word_t s[])
+    {
+        return rotl<R>(s[I] + s[J]) + s[I];
+    }
+};
+
+/* s[I] + s[J] */
+template <int I, int J>
+struct ScramblerPlus
+{
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline word_t output(const word_t s[])
+    {
+        return s[I] + s[J];
+    }
+};
+
+/* rotl(s[I] * 5, R) * 9, with the products done as shifts and additions so
+   that this also works on 'LaneVector's (which have no multiplication). */
+template <int I, int R>
+struct ScramblerStarStar
+{
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline word_t output(const word_t s[])
+    {
+        const word_t r = rotl<R>(s[I] + (s[I] << 2));
+        return r + (r << 3);
+    }
+};
+
+/* States of default-constructed generators. */
+constexpr static const uint64_t DEFAULT_STATE_X256PP[] = { 0x3d23dce41c588f8c, 0x10c770bb8da027b0, 0xc7a4c5e87c63ba25, 0xa830f83239465a2e };
+
+constexpr static const uint32_t DEFAULT_STATE_X128PP[] = { 0x1c588f8c, 0x3d23dce4, 0x8da027b0, 0x10c770bb };
+
+constexpr static const uint64_t DEFAULT_STATE_X512PP[] = {
+    0x3d23dce41c588f8c, 0x10c770bb8da027b0, 0xc7a4c5e87c63ba25, 0xa830f83239465a2e,
+    0x76a41459b420755d, 0xf56248ad1b839e50, 0x681045d39fe24737, 0x72a11c5fc8443645 };
+
+constexpr static const uint64_t DEFAULT_STATE_XORO128PP[] = { 0x3d23dce41c588f8c, 0x10c770bb8da027b0 };
+
+/* Word type, state transition, tables and default state of each state size.
+   The '+', '++' and '**' variants of the same size share all of these. */
+struct Xoshiro256Traits : XoshiroTransition4<17, 45>
+{
+    using word_type = std::uint64_t;
+    using table_row = word_type[4];
+
+    constexpr static const word_type* default_state()
+    {
+        return DEFAULT_STATE_X256PP;
+    }
+
+    constexpr static const word_type* jump_table()
+    {
+        return JUMP_X256PP;
+    }
+
+    constexpr static const word_type* long_jump_table()
+    {
+        return LONG_JUMP_X256PP;
+    }
+
+    constexpr static const table_row* jump_pow2_table()
+    {
+        return JUMP_POW2_X256PP;
+    }
+
+    constexpr static const word_type* charpoly()
+    {
+        return CHARPOLY_X256PP;
+    }
+};
+
+struct Xoshiro128Traits : XoshiroTransition4<9, 11>
+{
+    using word_type = std::uint32_t;
+    using table_row = word_type[4];
+
+    constexpr static const word_type* default_state()
+    {
+        return DEFAULT_STATE_X128PP;
+    }
+
+    constexpr static const word_type* jump_table()
+    {
+        return JUMP_X128PP;
+    }
+
+    constexpr static const word_type* long_jump_table()
+    {
+        return LONG_JUMP_X128PP;
+    }
+
+    constexpr static const table_row* jump_pow2_table()
+    {
+        return JUMP_POW2_X128PP;
+    }
+
+    constexpr static const word_type* charpoly()
+    {
+        return CHARPOLY_X128PP;
+    }
+};
+
+struct Xoshiro512Traits : XoshiroTransition8<11, 21>
+{
+    using word_type = std::uint64_t;
+    using table_row = word_type[8];
+
+    constexpr static const word_type* default_state()
+    {
+        return DEFAULT_STATE_X512PP;
+    }
+
+    constexpr static const word_type* jump_table()
+    {
+        return JUMP_X512PP;
+    }
+
+    constexpr static const word_type* long_jump_table()
+    {
+        return LONG_JUMP_X512PP;
+    }
+
+    constexpr static const table_row* jump_pow2_table()
+    {
+        return JUMP_POW2_X512PP;
+    }
+
+    constexpr static const word_type* charpoly()
+    {
+        return CHARPOLY_X512PP;
+    }
+};
+
+struct Xoroshiro128Traits : XoroshiroTransition2<49, 21, 28>
+{
+    using word_type = std::uint64_t;
+    using table_row = word_type[2];
+
+    constexpr static const word_type* default_state()
+    {
+        return DEFAULT_STATE_XORO128PP;
+    }
+
+    constexpr static const word_type* jump_table()
+    {
+        return JUMP_XORO128PP;
+    }
+
+    constexpr static const word_type* long_jump_table()
+    {
+        return LONG_JUMP_XORO128PP;
+    }
+
+    constexpr static const table_row* jump_pow2_table()
+    {
+        return JUMP_POW2_XORO128PP;
+    }
+
+    constexpr static const word_type* charpoly()
+    {
+        return CHARPOLY_XORO128PP;
+    }
+};
+
+/* Seeding from a 64-bit number: 64-bit words are consecutive outputs of
+   splitmix64, and each pair of 32-bit words comes from the two halves of one
+   output, each half passed again through splitmix64. */
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void seed_state(std::uint64_t *state, const int n_words, const std::uint64_t seed)
+{
+    state[0] = splitmix64(splitmix64(seed));
+    for (int ix = 1; ix < n_words; ix++)
+        state[ix] = splitmix64(state[ix-1]);
+}
+
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void seed_state(std::uint32_t *state, const int n_words, const std::uint64_t seed)
+{
+    std::uint64_t t = seed;
+    for (int ix = 0; ix < n_words; ix += 2)
+    {
+        t = splitmix64(t);
+        state[ix] = splitmix64(extract_32bits_from64_left(t));
+        state[ix + 1] = splitmix64(extract_32bits_from64_right(t));
+    }
+}
+
+/* Writing and reading 'n' words as bytes in little-endian order, which is a
+   plain copy on little-endian hosts. 'out' may be the bytes of 'words'
+   themselves, for converting an array in place. */
+template <class word_t>
+static inline void store_le(unsigned char *out, const word_t *words, const std::size_t n)
+{
+#if XOSHIRO_LITTLE_ENDIAN
+    std::memmove(out, words, n*sizeof(word_t));
+#else
+    for (std::size_t ix = 0; ix < n; ix++)
+    {
+        const word_t w = words[ix];
+        for (std::size_t b = 0; b < sizeof(word_t); b++)
+            out[ix*sizeof(word_t) + b] = static_cast<unsigned char>(w >> (8*b));
+    }
+#endif
+}
+
+template <class word_t>
+static inline void load_le(word_t *words, const unsigned char *in, const std::size_t n)
+{
+#if XOSHIRO_LITTLE_ENDIAN
+    std::memmove(words, in, n*sizeof(word_t));
+#else
+    for (std::size_t ix = 0; ix < n; ix++)
+    {
+        word_t w = 0;
+        for (std::size_t b = 0; b < sizeof(word_t); b++)
+            w |= static_cast<word_t>(in[ix*sizeof(word_t) + b]) << (8*b);
+        words[ix] = w;
+    }
+#endif
+}
+
+/* Common implementation of the generators, specialized at compile time by the
+   state size ('Traits') and the output function ('Scrambler'). 'Derived' is
+   the generator class itself (CRTP), which is what the jumping functions
+   return. */
+template <class Derived, class Traits, class Scrambler>
+class XoshiroEngine
+{
+public:
+    using result_type = typename Traits::word_type;
+    constexpr static const int state_words = Traits::state_words;
+    result_type state[state_words] = {};
+
+    constexpr static result_type min()
+    {
+        return 0;
+    }
+
+    constexpr static result_type max()
+    {
+        return static_cast<result_type>(~static_cast<result_type>(0));
+    }
+
+    XOSHIRO_CONSTEXPR XoshiroEngine()
+    {
+        for (int ix = 0; ix < state_words; ix++)
+            this->state[ix] = Traits::default_state()[ix];
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR void seed(const std::uint64_t seed)
+    {
+        seed_state(this->state, state_words, seed);
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR void seed(const result_type seed[state_words])
+    {
+        for (int ix = 0; ix < state_words; ix++)
+            this->state[ix] = seed[ix];
+    }
+
+    /* The 32-bit values of 'seq' fill the bytes of the state in order. */
+    template<class Sseq>
+    void seed(Sseq& seq)
+    {
+        std::uint32_t words[state_words*sizeof(result_type)/sizeof(std::uint32_t)];
+        seq.generate(words, words + sizeof(words)/sizeof(std::uint32_t));
+        std::memcpy(this->state, words, sizeof(words));
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR explicit XoshiroEngine(const std::uint64_t seed)
+    {
+        this->seed(seed);
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR explicit XoshiroEngine(const result_type seed[state_words])
+    {
+        this->seed(seed);
+    }
+
+    template<class Sseq>
+    explicit XoshiroEngine(Sseq& seq)
+    {
+        this->seed(seq);
+    }
+
+    /* Advances the state words 's' by one step and returns the output.
+       Used by every generation path so that they all produce the same sequence.
+       'word_t' is either 'result_type' or a 'LaneVector' of them. */
+    template <class word_t>
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline word_t step(word_t s[state_words])
+    {
+        const word_t result = Scrambler::output(s);
+        Traits::advance(s);
+        return result;
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR result_type operator()()
+    {
+        return step(this->state);
+    }
+
+    /* Fills the range [first, last) with the same values that would be obtained
+       by calling 'operator()' once per element, but keeping the state in local
+       variables for the whole loop. */
+    template <class OutputIt>
+    void generate(OutputIt first, OutputIt last)
+    {
+        result_type s[state_words];
+        std::memcpy(s, this->state, sizeof(s));
+        for (; first != last; ++first)
+            *first = step(s);
+        std::memcpy(this->state, s, sizeof(s));
+    }
+
+    void fill(result_type *out, const std::size_t n)
+    {
+        this->generate(out, out + n);
+    }
+
+    /* Uniform reals in [0, 1), from the highest 53 (double) or 24 (float)
+       bits of one output, except for doubles from 32-bit outputs, which take
+       two of them (the first giving the highest bits). */
+    double next_double()
+    {
+        return step_double(this->state);
+    }
+
+    float next_float()
+    {
+        return step_float(this->state);
+    }
+
+    void fill_double(double *out, const std::size_t n)
+    {
+        result_type s[state_words];
+        std::memcpy(s, this->state, sizeof(s));
+        for (std::size_t ix = 0; ix < n; ix++)
+            out[ix] = step_double(s);
+        std::memcpy(this->state, s, sizeof(s));
+    }
+
+    void fill_float(float *out, const std::size_t n)
+    {
+        result_type s[state_words];
+        std::memcpy(s, this->state, sizeof(s));
+        for (std::size_t ix = 0; ix < n; ix++)
+            out[ix] = step_float(s);
+        std::memcpy(this->state, s, sizeof(s));
+    }
+
+    /* Uniform integer in [0, range), for 'range' > 0, without bias, using
+       Lemire's multiply-shift method: the result is the high half of the
+       product of an output and 'range', and outputs for which the low half
+       falls below 2^B mod 'range' (B being the bits in 'result_type') are
+       rejected. That modulo is only computed when the low half is below
+       'range', which happens with probability range/2^B. */
+    result_type bounded(const result_type range)
+    {
+        return bounded_step(this->state, range);
+    }
+
+    /* Fills 'out' with 'n' draws of 'bounded(range)'. The rejection threshold
+       is computed once, so this does one division in total. A zero 'range'
+       gives zeros, as 'bounded(0)' does. */
+    void fill_bounded(result_type *out, const std::size_t n, const result_type range)
+    {
+        const result_type threshold = range? static_cast<result_type>(0 - range) % range : 0;
+        result_type s[state_words];
+        std::memcpy(s, this->state, sizeof(s));
+        for (std::size_t ix = 0; ix < n; ix++)
+        {
+            result_type lo;
+            result_type hi = mul_wide(step(s), range, lo);
+            while (lo < threshold)
+                hi = mul_wide(step(s), range, lo);
+            out[ix] = hi;
+        }
+        std::memcpy(this->state, s, sizeof(s));
+    }
+
+    /* Fills 'out' with 'bounded(ranges[i])' for i in [0, n), e.g. the indices
+       for a shuffle or for reservoir sampling. Same values as calling
+       'bounded' in a loop. */
+    void fill_bounded(result_type *out, const std::size_t n, const result_type *ranges)
+    {
+        result_type s[state_words];
+        std::memcpy(s, this->state, sizeof(s));
+        for (std::size_t ix = 0; ix < n; ix++)
+            out[ix] = bounded_step(s, ranges[ix]);
+        std::memcpy(this->state, s, sizeof(s));
+    }
+
+    /* Advances the state by 'z' steps. Large skips are done as one jump for each
+       set bit of 'z' above the lowest 'DISCARD_LOOP_BITS', so this takes time
+       proportional to the number of bits rather than to 'z'. */
+    XOSHIRO_CONSTEXPR void discard(unsigned long long z)
+    {
+        for (int k = DISCARD_LOOP_BITS; k < 64 && (z >> k); k++)
+            if ((z >> k) & 1ULL)
+                jump_state(Traits::jump_pow2_table()[k], *this);
+        z &= (1ULL << DISCARD_LOOP_BITS) - 1;
+        for (unsigned long long ix = 0; ix < z; ix++)
+            this->operator()();
+    }
+
+    XOSHIRO_CONSTEXPR Derived jump() const
+    {
+        Derived new_gen = this->derived();
+        jump_state(Traits::jump_table(), new_gen);
+        return new_gen;
+    }
+
+    XOSHIRO_CONSTEXPR Derived long_jump() const
+    {
+        Derived new_gen = this->derived();
+        jump_state(Traits::long_jump_table(), new_gen);
+        return new_gen;
+    }
+
+    using jump_polynomial_type = JumpPolynomial<result_type, state_words>;
+
+    /* Tables used by 'jump' and 'long_jump', for the functions that jump many generators at once. */
+    constexpr static const result_type* jump_table()
+    {
+        return Traits::jump_table();
+    }
+
+    constexpr static const result_type* long_jump_table()
+    {
+        return Traits::long_jump_table();
+    }
+
+    /* Returns the polynomial for jumping ahead by 'steps_hi*2^64 + steps_lo'
+       steps, to be used with 'jump_by_polynomial'. */
+    XOSHIRO_CONSTEXPR static jump_polynomial_type jump_polynomial(const std::uint64_t steps_lo, const std::uint64_t steps_hi = 0)
+    {
+        return jump_polynomial_for_distance(steps_lo, steps_hi, Traits::jump_pow2_table(), Traits::charpoly());
+    }
+
+    /* Returns the polynomial for jumping 'n' times by the distance of 'poly',
+       e.g. 'jump_polynomial_pow(jump_polynomial(0, 1), worker_id)' for streams
+       spaced by 2^64 steps. */
+    XOSHIRO_CONSTEXPR static jump_polynomial_type jump_polynomial_pow(const jump_polynomial_type &poly, const std::uint64_t n)
+    {
+        return poly_powmod(poly, n, 0, Traits::charpoly());
+    }
+
+    /* Returns the polynomial for jumping by the sum of the distances of 'a' and 'b'. */
+    XOSHIRO_CONSTEXPR static jump_polynomial_type jump_polynomial_mul(const jump_polynomial_type &a, const jump_polynomial_type &b)
+    {
+        return poly_mulmod(a, b, Traits::charpoly());
+    }
+
+    XOSHIRO_CONSTEXPR Derived jump_by_polynomial(const jump_polynomial_type &poly) const
+    {
+        Derived new_gen = this->derived();
+        jump_state(poly.coef, new_gen);
+        return new_gen;
+    }
+
+    XOSHIRO_CONSTEXPR Derived jump_ahead(const std::uint64_t steps_lo, const std::uint64_t steps_hi = 0) const
+    {
+        return this->jump_by_polynomial(jump_polynomial(steps_lo, steps_hi));
+    }
+
+    #ifdef __SIZEOF_INT128__
+    /* template only so that calls with plain integers go to the overload above */
+    template <class steps_t, typename std::enable_if<std::is_same<steps_t, uint128_t>::value, int>::type = 0>
+    XOSHIRO_CONSTEXPR Derived jump_ahead(const steps_t steps) const
+    {
+        return this->jump_ahead(static_cast<std::uint64_t>(steps), static_cast<std::uint64_t>(steps >> 64));
+    }
+    #endif
+
+    XOSHIRO_CONSTEXPR bool operator==(const Derived &rhs) const
+    {
+        for (int ix = 0; ix < state_words; ix++)
+            if (this->state[ix] != rhs.state[ix]) return false;
+        return true;
+    }
+
+    #ifndef HAS_CPP20
+    XOSHIRO_CONSTEXPR bool operator!=(const Derived &rhs) const
+    {
+        return !(*this == rhs);
+    }
+    #endif
+
+    /* The state as 'state_bytes' bytes, the words one after the other, each
+       in little-endian order, so that saved states can be read on any host.
+       The overloads taking spans return the rest of the span, for saving or
+       loading several generators one after the other. */
+    constexpr static const std::size_t state_bytes = state_words*sizeof(result_type);
+
+    void save(unsigned char *out) const
+    {
+        store_le(out, this->state, state_words);
+    }
+
+    void load(const unsigned char *in)
+    {
+        load_le(this->state, in, state_words);
+    }
+
+    #ifdef HAS_CPP20
+    std::span<std::byte> save(const std::span<std::byte> out) const
+    {
+        this->save(reinterpret_cast<unsigned char*>(out.data()));
+        return out.subspan(state_bytes);
+    }
+
+    std::span<const std::byte> load(const std::span<const std::byte> in)
+    {
+        this->load(reinterpret_cast<const unsigned char*>(in.data()));
+        return in.subspan(state_bytes);
+    }
+    #endif
+
+    template< class CharT, class CharTraits >
+    friend std::basic_ostream<CharT,CharTraits>&
+    operator<<(std::basic_ostream<CharT,CharTraits>& ost, const Derived& e)
+    {
+        for (int ix = 0; ix < state_words; ix++)
+        {
+            if (ix) ost.put(' ');
+            ost.write(reinterpret_cast<const char*>(&e.state[ix]), sizeof(result_type));
+        }
+        return ost;
+    }
+    template< class CharT, class CharTraits >
+    friend std::basic_istream<CharT,CharTraits>&
+    operator>>(std::basic_istream<CharT,CharTraits>& ist, Derived& e)
+    {
+        for (int ix = 0; ix < state_words; ix++)
+        {
+            if (ix) ist.get();
+            ist.read(reinterpret_cast<char*>(&e.state[ix]), sizeof(result_type));
+        }
+        return ist;
+    }
+
+private:
+    constexpr const Derived& derived() const
+    {
+        return static_cast<const Derived&>(*this);
+    }
+
+    /* Only the overloads matching 'result_type' get instantiated. */
+    static inline double step_double(std::uint64_t s[state_words])
+    {
+        return u64_to_double(step(s));
+    }
+
+    static inline double step_double(std::uint32_t s[state_words])
+    {
+        const std::uint32_t hi = step(s);
+        return u32_pair_to_double(hi, step(s));
+    }
+
+    static inline float step_float(std::uint64_t s[state_words])
+    {
+        return u64_to_float(step(s));
+    }
+
+    static inline float step_float(std::uint32_t s[state_words])
+    {
+        return u32_to_float(step(s));
+    }
+
+    static inline result_type bounded_step(result_type s[state_words], const result_type range)
+    {
+        result_type lo;
+        result_type hi = mul_wide(step(s), range, lo);
+        if (lo < range)
+        {
+            const result_type threshold = static_cast<result_type>(0 - range) % range;
+            while (lo < threshold)
+                hi = mul_wide(step(s), range, lo);
+        }
+        return hi;
+    }
+};
+
+/* The 32-bit generators take in addition 32-bit seeds and states given as two 64-bit words. */
+template <class Derived, class Scrambler>
+class Xoshiro128Engine : public XoshiroEngine<Derived, Xoshiro128Traits, Scrambler>
+{
+public:
+    using XoshiroEngine<Derived, Xoshiro128Traits, Scrambler>::XoshiroEngine;
+    using XoshiroEngine<Derived, Xoshiro128Traits, Scrambler>::seed;
+
+    Xoshiro128Engine() = default;
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR void seed(const std::uint32_t seed)
+    {
+        std::uint64_t temp = 0;
+        assign_32bits_to64_left(temp, seed);
+        assign_32bits_to64_right(temp, seed);
+        this->seed(temp);
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR void seed(const std::uint64_t seed[2])
+    {
+        for (int ix = 0; ix < 2; ix++)
+        {
+            this->state[2*ix] = extract_32bits_from64_left(seed[ix]);
+            this->state[2*ix + 1] = extract_32bits_from64_right(seed[ix]);
+        }
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR explicit Xoshiro128Engine(const std::uint32_t seed)
+    {
+        this->seed(seed);
+    }
+
+    XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR explicit Xoshiro128Engine(const std::uint64_t seed[2])
+    {
+        this->seed(seed);
+    }
+};
+
+/* This is xoshiro256++ 1.0, one of our all-purpose, rock-solid generators.
+   It has excellent (sub-ns) speed, a state (256 bits) that is large
+   enough for any parallel application, and it passes all tests we are
+   aware of.
+
+   For generating just floating-point numbers, xoshiro256+ (Xoshiro256P)
+   is even faster.
+
+   The state must be seeded so that it is not everywhere zero. If you have
+   a 64-bit seed, we suggest to seed a splitmix64 generator and use its
+   output to fill s. */
+class Xoshiro256PP : public XoshiroEngine<Xoshiro256PP, Xoshiro256Traits, ScramblerPlusPlus<0, 3, 23>>
+{
+public:
+    using XoshiroEngine::XoshiroEngine;
+    constexpr static const std::uint16_t wire_tag = 1;
+};
+
+/* This is xoshiro256+ 1.0, our best and fastest generator for floating-point
+   numbers. We suggest to use its upper bits for floating-point generation, as
+   it is slightly faster than xoshiro256++/xoshiro256**. It passes all tests we
+   are aware of except for the lowest three bits, which might fail linearity
+   tests (and just those), so if low linear complexity is not considered an
+   issue (as it is usually the case) it can be used to generate 64-bit outputs,
+   too.
+
+   It shares the state transition, and so the jump tables and seeding, with
+   xoshiro256++; only the output function differs.
+
+   We suggest to use a sign test to extract a random Boolean value, and
+   right shifts to extract subsets of bits.
+
+   The state must be seeded so that it is not everywhere zero. If you have
+   a 64-bit seed, we suggest to seed a splitmix64 generator and use its
+   output to fill s. */
+class Xoshiro256P : public XoshiroEngine<Xoshiro256P, Xoshiro256Traits, ScramblerPlus<0, 3>>
+{
+public:
+    using XoshiroEngine::XoshiroEngine;
+    constexpr static const std::uint16_t wire_tag = 2;
+};
+
+/* This is xoshiro256** 1.0, one of our all-purpose, rock-solid generators.
+   It has excellent (sub-ns) speed, a state (256 bits) that is large
+   enough for any parallel application, and it passes all tests we are
+   aware of.
+
+   It shares the state transition, and so the jump tables and seeding, with
+   xoshiro256++; only the output function differs.
+
+   The state must be seeded so that it is not everywhere zero. If you have
+   a 64-bit seed, we suggest to seed a splitmix64 generator and use its
+   output to fill s. */
+class Xoshiro256SS : public XoshiroEngine<Xoshiro256SS, Xoshiro256Traits, ScramblerStarStar<1, 7>>
+{
+public:
+    using XoshiroEngine::XoshiroEngine;
+    constexpr static const std::uint16_t wire_tag = 3;
+};
+
+/* This is xoshiro512++ 1.0, one of our all-purpose, rock-solid
+   generators. It has excellent (about 1ns) speed, a state (512 bits) that
+   is large enough for any parallel application, and it passes all tests
+   we are aware of.
+
+   The state must be seeded so that it is not everywhere zero. If you have
+   a 64-bit seed, we suggest to seed a splitmix64 generator and use its
+   output to fill s. */
+class Xoshiro512PP : public XoshiroEngine<Xoshiro512PP, Xoshiro512Traits, ScramblerPlusPlus<2, 0, 17>>
+{
+public:
+    using XoshiroEngine::XoshiroEngine;
+    constexpr static const std::uint16_t wire_tag = 4;
+};
+
+/* This is xoroshiro128++ 1.0, one of our all-purpose, rock-solid,
+   small-state generators. It is extremely (sub-ns) fast and it passes all
+   tests we are aware of, but its state space is large enough only for
+   mild parallelism.
+
+   The state must be seeded so that it is not everywhere zero. If you have
+   a 64-bit seed, we suggest to seed a splitmix64 generator and use its
+   output to fill s. */
+class Xoroshiro128PP : public XoshiroEngine<Xoroshiro128PP, Xoroshiro128Traits, ScramblerPlusPlus<0, 1, 17>>
+{
+public:
+    using XoshiroEngine::XoshiroEngine;
+    constexpr static const std::uint16_t wire_tag = 5;
+};
+
+/* This is xoshiro128++ 1.0, one of our 32-bit all-purpose, rock-solid
+   generators. It has excellent speed, a state size (128 bits) that is
+   large enough for mild parallelism, and it passes all tests we are aware
+   of.
+
+   For generating just single-precision (i.e., 32-bit) floating-point
+   numbers, xoshiro128+ (Xoshiro128P) is even faster.
+
+   The state must be seeded so that it is not everywhere zero. */
+class Xoshiro128PP : public Xoshiro128Engine<Xoshiro128PP, ScramblerPlusPlus<0, 3, 7>>
+{
+public:
+    using Xoshiro128Engine::Xoshiro128Engine;
+    constexpr static const std::uint16_t wire_tag = 6;
+};
+
+/* This is xoshiro128+ 1.0, our best and fastest 32-bit generator for 32-bit
+   floating-point numbers. We suggest to use its upper bits for
+   floating-point generation, as it is slightly faster than xoshiro128**.
+   It passes all tests we are aware of except for linearity tests, as the
+   lowest four bits have low linear complexity, so if low linear
+   complexity is not considered an issue (as it is usually the case) it
+   can be used to generate 32-bit outputs, too.
+
+   It shares the state transition, and so the jump tables and seeding, with
+   xoshiro128++; only the output function differs.
+
+   We suggest to use a sign test to extract a random Boolean value, and
+   right shifts to extract subsets of bits.
+
+   The state must be seeded so that it is not everywhere zero. */
+class Xoshiro128P : public Xoshiro128Engine<Xoshiro128P, ScramblerPlus<0, 3>>
+{
+public:
+    using Xoshiro128Engine::Xoshiro128Engine;
+    constexpr static const std::uint16_t wire_tag = 7;
+};
+
+/* SVE version of 'XoshiroLanes<Xoshiro128PP, W>::fill'. SVE registers have a
+   length that is only known at run time, so the lanes are processed in chunks
+   of as many words as the hardware vector holds, whatever 'W' is. Returns
+   'false' for engines that do not have such a version. */
+template <class rng_t, class word_t, int W>
+static inline bool fill_lanes_sve(const rng_t*, word_t (*)[W], word_t*, const std::size_t)
+{
+    return false;
+}
+
+#ifdef __ARM_FEATURE_SVE
+static inline svuint32_t rotl_sve(const svbool_t pg, const svuint32_t x, const int k)
+{
+    return svorr_u32_x(pg, svlsl_n_u32_x(pg, x, k), svlsr_n_u32_x(pg, x, 32 - k));
+}
+
+template <int W>
+static inline bool fill_lanes_sve(const Xoshiro128PP*, std::uint32_t (*state)[W], std::uint32_t *out, const std::size_t n)
+{
+    const std::size_t n_full = n / W;
+    const std::uint64_t n_last = n % W;
+    const std::size_t n_steps = n_full + (n_last? 1 : 0);
+    for (std::uint64_t lane = 0; lane < static_cast<std::uint64_t>(W); lane += svcntw())
+    {
+        const svbool_t pg = svwhilelt_b32_u64(lane, W);
+        const svbool_t pg_last = svand_b_z(pg, pg, svwhilelt_b32_u64(lane, n_last));
+        svuint32_t s0 = svld1_u32(pg, state[0] + lane);
+        svuint32_t s1 = svld1_u32(pg, state[1] + lane);
+        svuint32_t s2 = svld1_u32(pg, state[2] + lane);
+        svuint32_t s3 = svld1_u32(pg, state[3] + lane);
+        for (std::size_t ix = 0; ix < n_steps; ix++)
+        {
+            const svuint32_t result = svadd_u32_x(pg, rotl_sve(pg, svadd_u32_x(pg, s0, s3), 7), s0);
+            const svuint32_t t = svlsl_n_u32_x(pg, s1, 9);
+            s2 = sveor_u32_x(pg, s2, s0);
+            s3 = sveor_u32_x(pg, s3, s1);
+            s1 = sveor_u32_x(pg, s1, s2);
+            s0 = sveor_u32_x(pg, s0, s3);
+            s2 = sveor_u32_x(pg, s2, t);
+            s3 = rotl_sve(pg, s3, 11);
+            svst1_u32((ix < n_full)? pg : pg_last, out + ix*W + lane, result);
+        }
+        svst1_u32(pg, state[0] + lane, s0);
+        svst1_u32(pg, state[1] + lane, s1);
+        svst1_u32(pg, state[2] + lane, s2);
+        svst1_u32(pg, state[3] + lane, s3);
+    }
+    return true;
+}
+#endif /* __ARM_FEATURE_SVE */
+
+/* Runs 'W' independent streams of the engine 'rng_t' side by side, with the
+   state stored as one group of 'W' words per state word (structure-of-arrays),
+   so that each step is done with vector instructions when available.
+
+   The streams are separated with the jump function: lane 0 starts at the
+   state of the generator it is seeded from, lane 1 at that state after a
+   'jump()', lane 2 after two jumps, and so on. Each lane thus produces exactly
+   the same sequence as the scalar generator jumped the same number of times.
+
+   Outputs are interleaved by lane: after a call to 'fill', 'out[k*W + i]' is
+   the k-th value of lane 'i'. */
+template <class rng_t, int W>
+class XoshiroLanes
+{
+public:
+    using result_type = typename rng_t::result_type;
+    using vector_type = typename LaneVectorSelect<result_type, W>::type;
+    constexpr static const int state_words = rng_t::state_words;
+    alignas(64) result_type state[state_words][W];
+
+    constexpr static int lanes()
+    {
+        return W;
+    }
+
+    constexpr static result_type min()
+    {
+        return rng_t::min();
+    }
+
+    constexpr static result_type max()
+    {
+        return rng_t::max();
+    }
+
+    XoshiroLanes()
+    {
+        this->seed(rng_t());
+    }
+
+    explicit XoshiroLanes(const std::uint64_t seed)
+    {
+        this->seed(seed);
+    }
+
+    explicit XoshiroLanes(rng_t base)
+    {
+        this->seed(base);
+    }
+
+    void seed(const std::uint64_t seed)
+    {
+        this->seed(rng_t(seed));
+    }
+
+    void seed(rng_t base)
+    {
+        for (int lane = 0; lane < W; lane++)
+        {
+            if (lane) base = base.jump();
+            for (int w = 0; w < state_words; w++)
+                this->state[w][lane] = base.state[w];
+        }
+    }
+
+    /* Returns a scalar generator positioned where lane 'lane' currently is. */
+    rng_t lane(const int lane) const
+    {
+        rng_t out;
+        for (int w = 0; w < state_words; w++)
+            out.state[w] = this->state[w][lane];
+        return out;
+    }
+
+    /* Advances the lanes as 'fill' of 'z' values would: each one by 'z/W'
+       steps, plus one if 'z' is not a multiple of 'W'. */
+    void discard(unsigned long long z)
+    {
+        const unsigned long long rows = z / W + ((z % W)? 1 : 0);
+        for (int lane = 0; lane < W; lane++)
+        {
+            rng_t rng = this->lane(lane);
+            rng.discard(rows);
+            for (int w = 0; w < state_words; w++)
+                this->state[w][lane] = rng.state[w];
+        }
+    }
+
+    /* Advances every lane by one step, writing the output of lane 'i' to 'out[i]'. */
+    void next(result_type out[W])
+    {
+        this->fill(out, W);
+    }
+
+    /* Writes 'n' interleaved outputs. If 'n' is not a multiple of 'W', all the
+       lanes are still advanced on the last step and the values that do not
+       fit in 'out' are dropped. */
+    void fill(result_type *out, const std::size_t n)
+    {
+        #ifdef __ARM_FEATURE_SVE
+        if (fill_lanes_sve(static_cast<const rng_t*>(nullptr), this->state, out, n))
+            return;
+        #endif
+        if (!LaneVectorSelect<result_type, W>::native)
+        {
+            this->fill_by_lane(out, n);
+            return;
+        }
+        vector_type s[state_words];
+        for (int w = 0; w < state_words; w++)
+            s[w] = vector_type::load(this->state[w]);
+        std::size_t ix = 0;
+        for (; ix + W <= n; ix += W)
+            rng_t::step(s).store(out + ix);
+        if (ix < n)
+        {
+            result_type last[W];
+            rng_t::step(s).store(last);
+            std::memcpy(out + ix, last, (n - ix)*sizeof(result_type));
+        }
+        for (int w = 0; w < state_words; w++)
+            s[w].store(this->state[w]);
+    }
+
+    /* Uniform reals in [0, 1) made from the interleaved outputs, in the same
+       way as in the scalar engine (so doubles from 32-bit lanes take two
+       consecutive outputs). The raw values are generated in blocks and then
+       converted in a separate loop, in which the conversion is vectorized. */
+    void fill_double(double *out, const std::size_t n)
+    {
+        this->fill_uniform(out, n);
+    }
+
+    void fill_float(float *out, const std::size_t n)
+    {
+        this->fill_uniform(out, n);
+    }
+
+    /* The lanes one after the other, each as the scalar engine writes it. */
+    template< class CharT, class Traits >
+    friend std::basic_ostream<CharT,Traits>&
+    operator<<(std::basic_ostream<CharT,Traits>& ost, const XoshiroLanes& e)
+    {
+        for (int lane = 0; lane < W; lane++)
+        {
+            if (lane) ost.put(' ');
+            ost << e.lane(lane);
+        }
+        return ost;
+    }
+    template< class CharT, class Traits >
+    friend std::basic_istream<CharT,Traits>&
+    operator>>(std::basic_istream<CharT,Traits>& ist, XoshiroLanes& e)
+    {
+        for (int lane = 0; lane < W; lane++)
+        {
+            rng_t rng;
+            if (lane) ist.get();
+            ist >> rng;
+            for (int w = 0; w < state_words; w++)
+                e.state[w][lane] = rng.state[w];
+        }
+        return ist;
+    }
+
+private:
+    /* 'fill' without vector registers: the lanes in turn with the scalar
+       generator, a block of rows at a time so that the output stays in cache. */
+    void fill_by_lane(result_type *out, const std::size_t n)
+    {
+        constexpr std::size_t block_rows = 64;
+        const std::size_t n_rows = (n + W - 1) / W;
+        rng_t rngs[W];
+        for (int lane = 0; lane < W; lane++)
+            rngs[lane] = this->lane(lane);
+        for (std::size_t row = 0; row < n_rows; row += block_rows)
+        {
+            const std::size_t end = (n_rows - row < block_rows)? n_rows : row + block_rows;
+            for (int lane = 0; lane < W; lane++)
+            {
+                rng_t &rng = rngs[lane];
+                for (std::size_t ix = row*W + lane; ix < end*W; ix += W)
+                {
+                    const result_type value = rng();
+                    if (ix < n) out[ix] = value;
+                }
+            }
+        }
+        for (int lane = 0; lane < W; lane++)
+            for (int w = 0; w < state_words; w++)
+                this->state[w][lane] = rngs[lane].state[w];
+    }
+
+    template <class real_t>
+    void fill_uniform(real_t *out, const std::size_t n)
+    {
+        constexpr std::size_t per_real = (sizeof(real_t) > sizeof(result_type))? 2 : 1;
+        constexpr std::size_t block = 64 * W;
+        alignas(64) result_type raw[block * per_real];
+        for (std::size_t start = 0; start < n; start += block)
+        {
+            const std::size_t n_block = (n - start < block)? (n - start) : block;
+            /* whole rows: the state advances the same as with a partial last row */
+            const std::size_t n_raw = (n_block * per_real + W - 1) / W * W;
+            this->fill(raw, n_raw);
+            raw_to_uniform(raw, out + start, n_block);
+        }
+    }
+};
+
+using Xoshiro256PPx4 = XoshiroLanes<Xoshiro256PP, 4>;
+using Xoshiro256PPx8 = XoshiroLanes<Xoshiro256PP, 8>;
+using Xoshiro128PPx4 = XoshiroLanes<Xoshiro128PP, 4>;
+using Xoshiro128PPx8 = XoshiroLanes<Xoshiro128PP, 8>;
+using Xoshiro128PPx16 = XoshiroLanes<Xoshiro128PP, 16>;
+using Xoshiro256Px4 = XoshiroLanes<Xoshiro256P, 4>;
+using Xoshiro256Px8 = XoshiroLanes<Xoshiro256P, 8>;
+using Xoshiro128Px4 = XoshiroLanes<Xoshiro128P, 4>;
+using Xoshiro128Px8 = XoshiroLanes<Xoshiro128P, 8>;
+using Xoshiro128Px16 = XoshiroLanes<Xoshiro128P, 16>;
+using Xoshiro256SSx4 = XoshiroLanes<Xoshiro256SS, 4>;
+using Xoshiro256SSx8 = XoshiroLanes<Xoshiro256SS, 8>;
+using Xoshiro512PPx4 = XoshiroLanes<Xoshiro512PP, 4>;
+using Xoshiro512PPx8 = XoshiroLanes<Xoshiro512PP, 8>;
+using Xoroshiro128PPx4 = XoshiroLanes<Xoroshiro128PP, 4>;
+using Xoroshiro128PPx8 = XoshiroLanes<Xoroshiro128PP, 8>;
+
+/* Size assumed for cache lines when laying out generators used by different threads. */
+constexpr static const std::size_t CACHE_LINE_SIZE = 64;
+
+/* A generator alone in its own cache line, so that generators used by
+   different threads next to each other in memory do not false-share. */
+template <class rng_t>
+struct alignas(CACHE_LINE_SIZE) CacheAligned
+{
+    rng_t rng;
+};
+
+/* Fixed-size array of cache-aligned generators in one allocation, as returned
+   by 'make_streams'. Can be moved but not copied. */
+template <class rng_t>
+class StreamArray
+{
+public:
+    using value_type = CacheAligned<rng_t>;
+
+    StreamArray() = default;
+
+    explicit StreamArray(const std::size_t n)
+    {
+        if (!n) return;
+        if (n > (SIZE_MAX - CACHE_LINE_SIZE) / sizeof(value_type))
+            throw std::bad_array_new_length();
+        this->raw = ::operator new(n*sizeof(value_type) + CACHE_LINE_SIZE);
+        std::size_t offset = reinterpret_cast<std::uintptr_t>(this->raw) % CACHE_LINE_SIZE;
+        offset = offset? (CACHE_LINE_SIZE - offset) : 0;
+        this->ptr = reinterpret_cast<value_type*>(static_cast<char*>(this->raw) + offset);
+        for (std::size_t ix = 0; ix < n; ix++)
+            new (this->ptr + ix) value_type();
+        this->n = n;
+    }
+
+    ~StreamArray() noexcept
+    {
+        for (std::size_t ix = 0; ix < this->n; ix++)
+            this->ptr[ix].~value_type();
+        ::operator delete(this->raw);
+    }
+
+    StreamArray(const StreamArray &other) = delete;
+
+    StreamArray& operator=(const StreamArray &other) = delete;
+
+    StreamArray(StreamArray &&other) noexcept : raw(other.raw), ptr(other.ptr), n(other.n)
+    {
+        other.raw = nullptr;
+        other.ptr = nullptr;
+        other.n = 0;
+    }
+
+    StreamArray& operator=(StreamArray &&other) noexcept
+    {
+        std::swap(this->raw, other.raw);
+        std::swap(this->ptr, other.ptr);
+        std::swap(this->n, other.n);
+        return *this;
+    }
+
+    rng_t& operator[](const std::size_t ix)
+    {
+        return this->ptr[ix].rng;
+    }
+
+    const rng_t& operator[](const std::size_t ix) const
+    {
+        return this->ptr[ix].rng;
+    }
+
+    std::size_t size() const
+    {
+        return this->n;
+    }
+
+    value_type* data()
+    {
+        return this->ptr;
+    }
+
+    value_type* begin()
+    {
+        return this->ptr;
+    }
+
+    value_type* end()
+    {
+        return this->ptr + this->n;
+    }
+
+private:
+    void *raw = nullptr;
+    value_type *ptr = nullptr;
+    std::size_t n = 0;
+};
+
+/* Returns 'n' non-overlapping streams: stream 0 starts at the state of 'base',
+   and stream 'i' at the state of stream 'i-1' after a 'jump()' (or a
+   'long_jump()' if passing 'use_long_jump=true'). The first group of streams
+   is produced by chaining jumps, and every further group is obtained from the
+   previous one with a single batched jump by the whole group's span, so the
+   jumps are done in O(n) and mostly in vectorized passes. */
+template <class rng_t>
+static inline StreamArray<rng_t> make_streams(const rng_t &base, const std::size_t n, const bool use_long_jump = false)
+{
+    using word_t = typename rng_t::result_type;
+    using poly_t = typename rng_t::jump_polynomial_type;
+    constexpr std::size_t group = static_cast<std::size_t>(VECTOR_BYTES) / sizeof(word_t);
+    const word_t *table = use_long_jump? rng_t::long_jump_table() : rng_t::jump_table();
+
+    StreamArray<rng_t> out(n);
+    for (std::size_t ix = 0; ix < n && ix < group; ix++)
+    {
+        std::memcpy(out[ix].state, ix? out[ix-1].state : base.state, sizeof(base.state));
+        if (ix) jump_state(table, out[ix]);
+    }
+    if (n <= group) return out;
+
+    poly_t by_group;
+    std::memcpy(by_group.coef, table, sizeof(by_group.coef));
+    by_group = rng_t::jump_polynomial_pow(by_group, group);
+    rng_t batch[group];
+    for (std::size_t start = group; start < n; start += group)
+    {
+        const std::size_t n_batch = (n - start < group)? (n - start) : group;
+        for (std::size_t ix = 0; ix < n_batch; ix++)
+            batch[ix] = out[start - group + ix];
+        jump_state_many(by_group.coef, batch, n_batch);
+        for (std::size_t ix = 0; ix < n_batch; ix++)
+            out[start + ix] = batch[ix];
+    }
+    return out;
+}
+
+
+/* Returns the generator at which stream 'n' of 'make_streams(base, ...)'
+   starts, i.e. 'base' jumped 'n' times, doing a single jump pass. */
+template <class rng_t>
+static inline rng_t nth_stream(const rng_t &base, const std::uint64_t n, const bool use_long_jump = false)
+{
+    typename rng_t::jump_polynomial_type poly;
+    std::memcpy(poly.coef, use_long_jump? rng_t::long_jump_table() : rng_t::jump_table(), sizeof(poly.coef));
+    rng_t out = base;
+    jump_state(rng_t::jump_polynomial_pow(poly, n).coef, out);
+    return out;
+}
+
+/* States of 'n' generators as a structure of arrays, word 'w' of generator
+   'ix' at 'soa[w*n + ix]', which is 'soa_size<rng_t>(n)' words. When
+   consecutive GPU threads each step their own generator, every load and
+   store of a state word is then one contiguous (coalesced) access.
+   'soa_load' and 'soa_store' work on the host and on the device. */
+template <class rng_t>
+XOSHIRO_HOST_DEVICE constexpr static inline std::size_t soa_size(const std::size_t n)
+{
+    return n * rng_t::state_words;
+}
+
+template <class rng_t>
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline rng_t soa_load(const typename rng_t::result_type soa[],
+                                                                   const std::size_t n, const std::size_t ix)
+{
+    using word_t = typename rng_t::result_type;
+    word_t words[rng_t::state_words] = {};
+    for (int w = 0; w < rng_t::state_words; w++)
+        words[w] = soa[w*n + ix];
+    return rng_t(static_cast<const word_t*>(words));
+}
+
+template <class rng_t>
+XOSHIRO_HOST_DEVICE XOSHIRO_CONSTEXPR static inline void soa_store(const rng_t &rng, typename rng_t::result_type soa[],
+                                                                   const std::size_t n, const std::size_t ix)
+{
+    for (int w = 0; w < rng_t::state_words; w++)
+        soa[w*n + ix] = rng.state[w];
+}
+
+/* Writes the streams of 'make_streams(base, n, use_long_jump)' to 'soa' in
+   the layout above, e.g. one stream per GPU thread to be copied to the
+   device, where thread 'ix' does 'soa_load<rng_t>(soa, n, ix)', draws, and
+   'soa_store' when done. */
+template <class rng_t>
+static inline void make_soa_streams(const rng_t &base, const std::size_t n, typename rng_t::result_type soa[],
+                                    const bool use_long_jump = false)
+{
+    const StreamArray<rng_t> streams = make_streams(base, n, use_long_jump);
+    for (std::size_t ix = 0; ix < n; ix++)
+        soa_store(streams[ix], soa, n, ix);
+}
+
+/* Shared state behind 'thread_local_engine<rng_t>'. Epoch zero means that no
+   seed was set and the streams start from a default-constructed generator. */
+template <class rng_t>
+struct ThreadEngineRegistry
+{
+    static std::atomic<std::uint64_t> seed;
+    static std::atomic<std::uint64_t> epoch;
+    static std::atomic<std::uint64_t> next_stream;
+};
+
+template <class rng_t> std::atomic<std::uint64_t> ThreadEngineRegistry<rng_t>::seed(0);
+template <class rng_t> std::atomic<std::uint64_t> ThreadEngineRegistry<rng_t>::epoch(0);
+template <class rng_t> std::atomic<std::uint64_t> ThreadEngineRegistry<rng_t>::next_stream(0);
+
+/* Returns the calling thread's own generator. On its first call from a
+   thread (and the first one after a reseed), the thread claims the next
+   stream index from an atomic counter and gets the generator at that stream,
+   as per 'nth_stream', so no locks are taken and no two threads share a
+   stream. Streams are handed out in order of first use, thus with a fixed
+   number of threads the set of streams used by a run is reproducible.
+
+   Note: this is 'inline' rather than 'static inline' so that every
+   translation unit refers to the same thread-local generator. */
+template <class rng_t = Xoshiro256PP>
+inline rng_t& thread_local_engine()
+{
+    using registry = ThreadEngineRegistry<rng_t>;
+    static thread_local rng_t engine;
+    static thread_local std::uint64_t engine_epoch = UINT64_MAX;
+    const std::uint64_t epoch = registry::epoch.load(std::memory_order_acquire);
+    if (engine_epoch != epoch)
+    {
+        const rng_t base = epoch? rng_t(registry::seed.load(std::memory_order_relaxed)) : rng_t();
+        engine = nth_stream(base, registry::next_stream.fetch_add(1, std::memory_order_relaxed));
+        engine_epoch = epoch;
+    }
+    return engine;
+}
+
+/* Sets the seed from which 'thread_local_engine<rng_t>' streams derive and
+   starts a new epoch: each thread claims a new stream, counting again from
+   zero, on its next call. Should be called while no thread is drawing. */
+template <class rng_t = Xoshiro256PP>
+inline void reseed_thread_local_engines(const std::uint64_t seed)
+{
+    using registry = ThreadEngineRegistry<rng_t>;
+    registry::seed.store(seed, std::memory_order_relaxed);
+    registry::next_stream.store(0, std::memory_order_relaxed);
+    registry::epoch.fetch_add(1, std::memory_order_release);
+}
+
+
+/* Returns the generator for task 'task_index' under 'seed', in O(1) and
+   regardless of which thread asks for it, for task-parallel code where the
+   thread running a task is not known in advance. The state is filled with
+   the splitmix64 sequence started from a per-task key,
+   'splitmix64(splitmix64(seed) ^ splitmix64(task_index))'. That key, and the
+   first draw from it, are bijections of the task index, so no two tasks
+   start from the same state; but unlike jumped streams the sequences are not
+   guaranteed to be non-overlapping (overlaps are just very unlikely). See
+   'SubstreamLadder' for jump-separated streams indexed the same way. */
+template <class rng_t>
+static inline rng_t task_substream(const std::uint64_t seed, const std::uint64_t task_index)
+{
+    using word_t = typename rng_t::result_type;
+    constexpr std::size_t state_bytes = sizeof(rng_t::state);
+    constexpr std::size_t n_words = state_bytes / sizeof(word_t);
+    constexpr std::size_t n_draws = state_bytes / sizeof(std::uint64_t);
+    constexpr std::uint64_t gamma = 0x9e3779b97f4a7c15;
+    const std::uint64_t key = splitmix64(splitmix64(seed) ^ splitmix64(task_index));
+    rng_t out;
+    for (std::size_t ix = 0; ix < n_draws; ix++)
+    {
+        const std::uint64_t draw = splitmix64(key + ix*gamma);
+        if (n_words == n_draws)
+        {
+            out.state[ix] = static_cast<word_t>(draw);
+        }
+        else
+        {
+            out.state[2*ix] = static_cast<word_t>(draw);
+            out.state[2*ix + 1] = static_cast<word_t>(draw >> 32);
+        }
+    }
+    return out;
+}
+
+/* Gives out the same generators as 'nth_stream(base, index)', keeping the
+   jump polynomials for each jump count 2^k, so that getting stream 'index'
+   takes one polynomial product per set bit of 'index' and a single jump,
+   instead of raising the polynomial to the power 'index' every time. Building
+   the ladder takes 64 polynomial squarings. */
+template <class rng_t>
+class SubstreamLadder
+{
+public:
+    using poly_type = typename rng_t::jump_polynomial_type;
+
+    explicit SubstreamLadder(const rng_t &base, const bool use_long_jump = false) : base(base)
+    {
+        std::memcpy(this->powers[0].coef, use_long_jump? rng_t::long_jump_table() : rng_t::jump_table(),
+                    sizeof(this->powers[0].coef));
+        for (int k = 1; k < 64; k++)
+            this->powers[k] = rng_t::jump_polynomial_pow(this->powers[k-1], 2);
+    }
+
+    /* Streams spaced by the distance of 'step' instead of a (long) jump. */
+    SubstreamLadder(const rng_t &base, const poly_type &step) : base(base)
+    {
+        this->powers[0] = step;
+        for (int k = 1; k < 64; k++)
+            this->powers[k] = rng_t::jump_polynomial_pow(this->powers[k-1], 2);
+    }
+
+    rng_t operator()(std::uint64_t index) const
+    {
+        poly_type poly = {{1}};
+        for (int k = 0; index; k++, index >>= 1)
+            if (index & 1)
+                poly = rng_t::jump_polynomial_mul(poly, this->powers[k]);
+        rng_t out = this->base;
+        jump_state(poly.coef, out);
+        return out;
+    }
+
+private:
+    rng_t base;
+    poly_type powers[64];
+};
+
+
+/* Adaptor that produces the outputs of 'rng_t' in blocks of 'N' values, using
+   the engine's bulk 'fill', and hands them out one at a time. This keeps the
+   engine state out of the caller's hot loop, at the price of holding the
+   block in memory. It produces the same sequence as the wrapped engine (when
+   wrapping a 'XoshiroLanes', the lane-interleaved sequence of its 'fill',
+   provided 'N' is a multiple of the number of lanes).
+
+   Serialization records the engine state at the start of the current block
+   and the position within it, so that restoring gives an exact continuation. */
+template <class rng_t, std::size_t N = 256>
+class Buffered
+{
+public:
+    using result_type = typename rng_t::result_type;
+    using engine_type = rng_t;
+
+    constexpr static result_type min()
+    {
+        return rng_t::min();
+    }
+
+    constexpr static result_type max()
+    {
+        return rng_t::max();
+    }
+
+    Buffered() = default;
+
+    explicit Buffered(const rng_t &engine) : engine(engine), block_start(engine) {}
+
+    explicit Buffered(const std::uint64_t seed) : engine(seed), block_start(engine) {}
+
+    void seed(const std::uint64_t seed)
+    {
+        this->seed(rng_t(seed));
+    }
+
+    void seed(const rng_t &engine)
+    {
+        this->engine = engine;
+        this->block_start = engine;
+        this->pos = N;
+    }
+
+    result_type operator()()
+    {
+        if (this->pos == N) this->refill();
+        return this->buffer[this->pos++];
+    }
+
+    void discard(unsigned long long z)
+    {
+        const std::size_t available = N - this->pos;
+        if (z <= available)
+        {
+            this->pos += static_cast<std::size_t>(z);
+            return;
+        }
+        z -= available;
+        this->engine.discard(z - z % N);
+        this->pos = N;
+        if (z % N)
+        {
+            this->refill();
+            this->pos = static_cast<std::size_t>(z % N);
+        }
+    }
+
+    /* The wrapped engine, positioned after the current block. */
+    const rng_t& base() const
+    {
+        return this->engine;
+    }
+
+    template< class CharT, class Traits >
+    friend std::basic_ostream<CharT,Traits>&
+    operator<<(std::basic_ostream<CharT,Traits>& ost, const Buffered& e)
+    {
+        const std::uint64_t pos = e.pos;
+        ost << ((e.pos == N)? e.engine : e.block_start);
+        ost.put(' ');
+        ost.write(reinterpret_cast<const char*>(&pos), sizeof(std::uint64_t));
+        return ost;
+    }
+    template< class CharT, class Traits >
+    friend std::basic_istream<CharT,Traits>&
+    operator>>(std::basic_istream<CharT,Traits>& ist, Buffered& e)
+    {
+        std::uint64_t pos;
+        ist >> e.engine;
+        ist.get();
+        ist.read(reinterpret_cast<char*>(&pos), sizeof(std::uint64_t));
+        e.block_start = e.engine;
+        e.pos = N;
+        if (pos < N)
+        {
+            e.refill();
+            e.pos = static_cast<std::size_t>(pos);
+        }
+        return ist;
+    }
+
+private:
+    rng_t engine;
+    rng_t block_start;
+    std::size_t pos = N;
+    alignas(64) result_type buffer[N];
+
+    void refill()
+    {
+        this->block_start = this->engine;
+        this->engine.fill(this->buffer, N);
+        this->pos = 0;
+    }
+};
+
+
+/* Hint for the processor to start loading the cache line at 'addr'. */
+#if defined(__GNUC__) || defined(__clang__)
+#   define XOSHIRO_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#   define XOSHIRO_PREFETCH(addr)
+#endif
+
+/* 64 random bits from any of the generators (two outputs for 32-bit ones). */
+template <class rng_t>
+static inline std::uint64_t random_u64(rng_t &rng)
+{
+    if (sizeof(typename rng_t::result_type) >= sizeof(std::uint64_t))
+        return static_cast<std::uint64_t>(rng());
+    const std::uint64_t hi = static_cast<std::uint64_t>(rng());
+    return (hi << 32) | static_cast<std::uint64_t>(rng());
+}
+
+/* Uniform integer in [0, range) from 64-bit draws, as in 'bounded'. */
+template <class rng_t>
+static inline std::uint64_t bounded_u64(rng_t &rng, const std::uint64_t range)
+{
+    std::uint64_t lo;
+    std::uint64_t hi = mul_wide(random_u64(rng), range, lo);
+    if (lo < range)
+    {
+        const std::uint64_t threshold = (0 - range) % range;
+        while (lo < threshold)
+            hi = mul_wide(random_u64(rng), range, lo);
+    }
+    return hi;
+}
+
+/* Largest 'n1' for which 'bounded_pair(rng, n1, n1 - 1, ...)' is valid. */
+constexpr static const std::uint64_t BOUNDED_PAIR_MAX = std::uint64_t(1) << 32;
+
+/* Draws 'j1' in [0, n1) and 'j2' in [0, n2) from a single 64-bit draw, with
+   the batched version of the multiply-shift method (Brackett-Rozinsky and
+   Lemire): 'j1' is the high half of draw*n1, 'j2' the high half of the low
+   half times 'n2', and the draw is rejected based on the low half that is
+   left, against 2^64 mod n1*n2. Both are unbiased and independent as long as
+   n1*n2 fits in 64 bits. */
+template <class rng_t>
+static inline void bounded_pair(rng_t &rng, const std::uint64_t n1, const std::uint64_t n2,
+                                std::uint64_t &j1, std::uint64_t &j2)
+{
+    const std::uint64_t bound = n1 * n2;
+    std::uint64_t lo;
+    j1 = mul_wide(random_u64(rng), n1, lo);
+    j2 = mul_wide(lo, n2, lo);
+    if (lo < bound)
+    {
+        const std::uint64_t threshold = (0 - bound) % bound;
+        while (lo < threshold)
+        {
+            j1 = mul_wide(random_u64(rng), n1, lo);
+            j2 = mul_wide(lo, n2, lo);
+        }
+    }
+}
+
+/* Positions of a shuffle for which the swap targets are drawn ahead of the
+   swaps, so that the targets can be prefetched. */
+constexpr static const int SHUFFLE_BLOCK = 64;
+
+/* Fisher-Yates shuffle of [first, last). Unlike 'std::shuffle', the swap
+   targets are drawn two at a time from one 64-bit draw (see 'bounded_pair')
+   while the ranges allow it, in blocks of 'SHUFFLE_BLOCK' positions, and each
+   target is prefetched before the block is swapped. The generator is used from
+   a local copy and written back at the end. The result is a uniformly random
+   permutation, but not the same one that 'std::shuffle' gives. */
+template <class RandomIt, class rng_t>
+static inline void shuffle(RandomIt first, RandomIt last, rng_t &rng)
+{
+    using std::swap;
+    std::uint64_t i = static_cast<std::uint64_t>(last - first);
+    if (i < 2) return;
+    rng_t gen = rng;
+    std::uint64_t targets[SHUFFLE_BLOCK];
+    /* remaining positions are [0, i): position i-1 is swapped with a target in [0, i) */
+    while (i > 1)
+    {
+        const int n_block = static_cast<int>((i - 1 < static_cast<std::uint64_t>(SHUFFLE_BLOCK))? (i - 1) : SHUFFLE_BLOCK);
+        for (int k = 0; k < n_block;)
+        {
+            const std::uint64_t range = i - static_cast<std::uint64_t>(k);
+            if (k + 1 < n_block && range <= BOUNDED_PAIR_MAX)
+            {
+                bounded_pair(gen, range, range - 1, targets[k], targets[k+1]);
+                XOSHIRO_PREFETCH(&*(first + targets[k]));
+                XOSHIRO_PREFETCH(&*(first + targets[k+1]));
+                k += 2;
+            }
+            else
+            {
+                targets[k] = bounded_u64(gen, range);
+                XOSHIRO_PREFETCH(&*(first + targets[k]));
+                k += 1;
+            }
+        }
+        for (int k = 0; k < n_block; k++)
+            swap(first[i - 1 - static_cast<std::uint64_t>(k)], first[targets[k]]);
+        i -= static_cast<std::uint64_t>(n_block);
+    }
+    rng = gen;
+}
+
+/* Writes to 'out' 'k' elements taken uniformly at random without replacement
+   from [first, last) (all of them if there are fewer), in a single pass over
+   the input, which needs not have a known size. This is reservoir sampling,
+   with the draws for two consecutive elements taken from one 64-bit draw.
+   The order of the elements in 'out' is unspecified. Returns the end of the
+   written range. */
+template <class InputIt, class RandomIt, class rng_t>
+static inline RandomIt sample_without_replacement(InputIt first, InputIt last, RandomIt out, const std::size_t k,
+                                                  rng_t &rng)
+{
+    std::uint64_t seen = 0;
+    for (; first != last && seen < k; ++first, ++seen)
+        out[seen] = *first;
+    if (first == last) return out + seen;
+
+    rng_t gen = rng;
+    bool have_next = false;
+    std::uint64_t j_next = 0;
+    for (; first != last; ++first, ++seen)
+    {
+        std::uint64_t j;
+        if (have_next)
+        {
+            j = j_next;
+            have_next = false;
+        }
+        else if (seen + 2 <= BOUNDED_PAIR_MAX)
+        {
+            bounded_pair(gen, seen + 1, seen + 2, j, j_next);
+            have_next = true;
+        }
+        else
+        {
+            j = bounded_u64(gen, seen + 1);
+        }
+        if (j < k) out[j] = *first;
+    }
+    rng = gen;
+    return out + k;
+}
+
+/* Runs 'task(i)' for every 'i' in [0, n_tasks) on 'n_threads' threads (the
+   calling one among them, zero meaning one per hardware thread), each taking
+   the next index from a shared counter. */
+template <class Task>
+static inline void run_tasks(const std::size_t n_tasks, unsigned n_threads, const Task &task)
+{
+    if (!n_threads) n_threads = std::thread::hardware_concurrency();
+    if (!n_threads) n_threads = 1;
+    if (n_threads > n_tasks) n_threads = static_cast<unsigned>(n_tasks);
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        for (std::size_t ix = next.fetch_add(1); ix < n_tasks; ix = next.fetch_add(1))
+            task(ix);
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < n_threads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+/* Target size of the buckets of 'shuffle_parallel', so that each one is
+   shuffled within the cache. */
+constexpr static const std::size_t SHUFFLE_BUCKET_BYTES = 256 * 1024;
+
+/* Pieces into which the input of 'shuffle_parallel' is split for scattering. */
+constexpr static const std::size_t SHUFFLE_CHUNKS = 64;
+
+/* Shuffle for arrays much larger than the cache, on 'n_threads' threads
+   (zero meaning one per hardware thread). Every element is sent to a bucket
+   chosen uniformly at random, buckets being sized to fit in the cache, then
+   each bucket is shuffled on its own with 'shuffle' and the buckets are laid
+   out one after another, which gives a uniformly random permutation
+   (Sanders, 1998). It takes a temporary copy of the data.
+
+   The input pieces and the buckets each draw from their own stream, as given
+   by 'SubstreamLadder' from the state of 'rng', so the result depends only on
+   that state and not on the number of threads. 'rng' is left at its
+   'long_jump()', past all those streams. */
+template <class RandomIt, class rng_t>
+static inline void shuffle_parallel(RandomIt first, RandomIt last, rng_t &rng, const unsigned n_threads = 0)
+{
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    int bucket_bits = 0;
+    while (bucket_bits < 16 && (n * sizeof(value_type) >> bucket_bits) > SHUFFLE_BUCKET_BYTES)
+        bucket_bits++;
+    if (bucket_bits < 2)
+    {
+        shuffle(first, last, rng);
+        return;
+    }
+    const std::size_t n_buckets = std::size_t(1) << bucket_bits;
+    const std::size_t chunk_size = (n + SHUFFLE_CHUNKS - 1) / SHUFFLE_CHUNKS;
+    const SubstreamLadder<rng_t> streams(rng);
+
+    /* the bucket of every element is drawn twice, to count and then to scatter */
+    std::vector<std::size_t> offsets(SHUFFLE_CHUNKS * n_buckets, 0);
+    auto chunk_range = [&](const std::size_t chunk, std::size_t &begin, std::size_t &end) {
+        begin = chunk * chunk_size;
+        end = (begin + chunk_size < n)? (begin + chunk_size) : n;
+        if (begin > n) begin = n;
+    };
+    run_tasks(SHUFFLE_CHUNKS, n_threads, [&](const std::size_t chunk) {
+        std::size_t begin, end;
+        chunk_range(chunk, begin, end);
+        rng_t gen = streams(chunk);
+        std::size_t *counts = offsets.data() + chunk * n_buckets;
+        for (std::size_t ix = begin; ix < end; ix++)
+            counts[random_u64(gen) >> (64 - bucket_bits)]++;
+    });
+
+    /* offsets[chunk][bucket]: buckets in order, and within a bucket the chunks in order */
+    std::vector<std::size_t> bucket_start(n_buckets + 1);
+    std::size_t total = 0;
+    for (std::size_t bucket = 0; bucket < n_buckets; bucket++)
+    {
+        bucket_start[bucket] = total;
+        for (std::size_t chunk = 0; chunk < SHUFFLE_CHUNKS; chunk++)
+        {
+            const std::size_t count = offsets[chunk * n_buckets + bucket];
+            offsets[chunk * n_buckets + bucket] = total;
+            total += count;
+        }
+    }
+    bucket_start[n_buckets] = total;
+
+    std::vector<value_type> buffer(n);
+    run_tasks(SHUFFLE_CHUNKS, n_threads, [&](const std::size_t chunk) {
+        std::size_t begin, end;
+        chunk_range(chunk, begin, end);
+        rng_t gen = streams(chunk);
+        std::size_t *positions = offsets.data() + chunk * n_buckets;
+        for (std::size_t ix = begin; ix < end; ix++)
+            buffer[positions[random_u64(gen) >> (64 - bucket_bits)]++] = std::move(first[ix]);
+    });
+
+    run_tasks(n_buckets, n_threads, [&](const std::size_t bucket) {
+        rng_t gen = streams(SHUFFLE_CHUNKS + bucket);
+        const std::size_t begin = bucket_start[bucket], end = bucket_start[bucket + 1];
+        shuffle(buffer.begin() + begin, buffer.begin() + end, gen);
+        for (std::size_t ix = begin; ix < end; ix++)
+            first[ix] = std::move(buffer[ix]);
+    });
+
+    rng = rng.long_jump();
+}
+
+
+/* Tables for the ziggurat method with 256 layers (Marsaglia and Tsang, 2000),
+   in the layout of Doornik's ZIGNOR: 'X[i]' is the right edge of layer 'i'
+   (with 'X[0]' = V/f(R) for the base layer, holding the tail, and
+   'X[256]' = 0) and 'F[i]' = f(X[i]), 'f' being the density without its
+   normalizing constant. 'R' is the start of the tail, and each layer has
+   area 'V'. Computed with 'x[i+1] = f^-1(V/x[i] + f(x[i]))'. */
+constexpr static const double ZIGGURAT_NORMAL_R = 3.654152885361008796;
+
+constexpr static const double ZIGGURAT_EXP_R = 7.697117470131487;
+
+constexpr static const double ZIGGURAT_NORMAL_X[257] = {
+    3.91075795953709004e+00, 3.65415288536100880e+00, 3.44927829856096446e+00, 3.32024473383916607e+00,
+    3.22457505204702910e+00, 3.14788928951714997e+00, 3.08352613200123304e+00, 3.02783779176863543e+00,
+    2.97860327988084483e+00, 2.93436686720785422e+00, 2.89412105361234806e+00, 2.85713873087213255e+00,
+    2.82287739682532512e+00, 2.79092117400078576e+00, 2.76094400527882256e+00, 2.73268535904282706e+00,
+    2.70593365612185810e+00, 2.68051464328452216e+00, 2.65628303757550244e+00, 2.63311639363032457e+00,
+    2.61091051848754852e+00, 2.58957598670699518e+00, 2.56903545268053657e+00, 2.54922155032346076e+00,
+    2.53007523215851693e+00, 2.51154444162534229e+00, 2.49358304126968067e+00, 2.47614993966914332e+00,
+    2.45920837433331130e+00, 2.44272531819895677e+00, 2.42667098493572597e+00, 2.41101841389968552e+00,
+    2.39574311978048060e+00, 2.38082279517062601e+00, 2.36623705671581863e+00, 2.35196722737765995e+00,
+    2.33799614879503137e+00, 2.32430801886962302e+00, 2.31088825059985004e+00, 2.29772334890132957e+00,
+    2.28480080272294606e+00, 2.27210899022682389e+00, 2.25963709517221778e+00, 2.24737503294580776e+00,
+    2.23531338492832798e+00, 2.22344334009090572e+00, 2.21175664288254437e+00, 2.20024554660964800e+00,
+    2.18890277162472069e+00, 2.17772146773864161e+00, 2.16669518035264597e+00, 2.15581781987506327e+00,
+    2.14508363404620361e+00, 2.13448718284432015e+00, 2.12402331568781566e+00, 2.11368715068493396e+00,
+    2.10347405571314683e+00, 2.09337963113705028e+00, 2.08339969399655178e+00, 2.07353026351697878e+00,
+    2.06376754780995642e+00, 2.05410793164886485e+00, 2.04454796521573279e+00, 2.03508435372780871e+00,
+    2.02571394786203296e+00, 2.01643373490437172e+00, 2.00724083055868485e+00, 1.99813247135656424e+00,
+    1.98910600761557133e+00, 1.98015889689859836e+00, 1.97128869793176964e+00, 1.96249306494246190e+00,
+    1.95376974238273404e+00, 1.94511656000675393e+00, 1.93653142827375890e+00, 1.92801233405071826e+00,
+    1.91955733659122885e+00, 1.91116456376928223e+00, 1.90283220854844637e+00, 1.89455852566871008e+00,
+    1.88634182853477639e+00, 1.87818048629097767e+00, 1.87007292106923684e+00, 1.86201760539763228e+00,
+    1.85401305975814812e+00, 1.84605785028311975e+00, 1.83815058658072861e+00, 1.83028991968066657e+00,
+    1.82247454009178322e+00, 1.81470317596416764e+00, 1.80697459134869343e+00, 1.79928758454758020e+00,
+    1.79164098655001003e+00, 1.78403365954727633e+00, 1.77646449552234498e+00, 1.76893241490907793e+00,
+    1.76143636531670666e+00, 1.75397532031545511e+00, 1.74654827827949299e+00, 1.73915426128366901e+00,
+    1.73179231405070722e+00, 1.72446150294577571e+00, 1.71716091501554069e+00, 1.70988965706900609e+00,
+    1.70264685479761391e+00, 1.69543165193223855e+00, 1.68824320943485873e+00, 1.68108070472282334e+00,
+    1.67394333092376035e+00, 1.66683029615928668e+00, 1.65974082285578950e+00, 1.65267414708064853e+00,
+    1.64562951790236034e+00, 1.63860619677311115e+00, 1.63160345693242204e+00, 1.62462058283056843e+00,
+    1.61765686957053423e+00, 1.61071162236733367e+00, 1.60378415602358304e+00, 1.59687379442026134e+00,
+    1.58997987002164853e+00, 1.58310172339347144e+00, 1.57623870273333289e+00, 1.56939016341253446e+00,
+    1.56255546752843966e+00, 1.55573398346655489e+00, 1.54892508547153551e+00, 1.54212815322634755e+00,
+    1.53534257143884312e+00, 1.52856772943502461e+00, 1.52180302075829310e+00, 1.51504784277399240e+00,
+    1.50830159627857197e+00, 1.50156368511270655e+00, 1.49483351577771839e+00, 1.48811049705465437e+00,
+    1.48139403962537575e+00, 1.47468355569502552e+00, 1.46797845861523091e+00, 1.46127816250740783e+00,
+    1.45458208188552329e+00, 1.44788963127766968e+00, 1.44120022484579802e+00, 1.43451327600294642e+00,
+    1.42782819702729036e+00, 1.42114439867232312e+00, 1.41446128977246466e+00, 1.40777827684337153e+00,
+    1.40109476367620256e+00, 1.39441015092507126e+00, 1.38772383568688462e+00, 1.38103521107274196e+00,
+    1.37434366577003053e+00, 1.36764858359431796e+00, 1.36094934303010184e+00, 1.35424531675943061e+00,
+    1.34753587117735929e+00, 1.34082036589315212e+00, 1.33409815321608360e+00, 1.32736857762462468e+00,
+    1.32063097521773010e+00, 1.31388467314686896e+00, 1.30712898902735386e+00, 1.30036323032743373e+00,
+    1.29358669373351765e+00, 1.28679866448978641e+00, 1.27999841571033324e+00, 1.27318520766184373e+00,
+    1.26635828701468833e+00, 1.25951688606014423e+00, 1.25266022189129789e+00, 1.24578749554499790e+00,
+    1.23889789110202742e+00, 1.23199057474244511e+00, 1.22506469375280802e+00, 1.21811937548172655e+00,
+    1.21115372623991124e+00, 1.20416683014056014e+00, 1.19715774787558593e+00, 1.19012551542280165e+00,
+    1.18306914267876073e+00, 1.17598761201148982e+00, 1.16887987672683380e+00, 1.16174485944157424e+00,
+    1.15458145035585180e+00, 1.14738850541673387e+00, 1.14016484436399579e+00, 1.13290924864833698e+00,
+    1.12562045921129439e+00, 1.11829717411506291e+00, 1.11093804600924950e+00, 1.10354167942026815e+00,
+    1.09610662784760349e+00, 1.08863139064951420e+00, 1.08111440969888939e+00, 1.07355406578787171e+00,
+    1.06594867475750665e+00, 1.05829648332600645e+00, 1.05059566458620712e+00, 1.04284431313937054e+00,
+    1.03504043982860527e+00, 1.02718196603075129e+00, 1.01926671746052921e+00, 1.01129241743497844e+00,
+    1.00325667953959141e+00, 9.95156999629943084e-01, 9.86990747093846266e-01, 9.78755155288937750e-01,
+    9.70447311058864615e-01, 9.62064143217605250e-01, 9.53602409875572654e-01, 9.45058684462571130e-01,
+    9.36429340280896860e-01, 9.27710533396234771e-01, 9.18898183643734989e-01, 9.09987953490768997e-01,
+    9.00975224455174528e-01, 8.91855070726792376e-01, 8.82622229578910122e-01, 8.73271068082494550e-01,
+    8.63795545546826915e-01, 8.54189171001560554e-01, 8.44444954902423661e-01, 8.34555354079518752e-01,
+    8.24512208745288633e-01, 8.14306670128064347e-01, 8.03929116982664893e-01, 7.93369058833152785e-01,
+    7.82615023299588763e-01, 7.71654424216739354e-01, 7.60473406422083165e-01, 7.49056662009581653e-01,
+    7.37387211425838629e-01, 7.25446140901303549e-01, 7.13212285182022732e-01, 7.00661841097584448e-01,
+    6.87767892786257717e-01, 6.74499822827436479e-01, 6.60822574234205984e-01, 6.46695714884388928e-01,
+    6.32072236375024632e-01, 6.16896989996235545e-01, 6.01104617743940417e-01, 5.84616766093722262e-01,
+    5.67338257040473026e-01, 5.49151702313026790e-01, 5.29909720646495108e-01, 5.09423329585933393e-01,
+    4.87443966121754335e-01, 4.63634336771763245e-01, 4.37518402186662658e-01, 4.08389134588000746e-01,
+    3.75121332850465727e-01, 3.35737519180459465e-01, 2.86174591747260509e-01, 2.15241895913273806e-01,
+    0.00000000000000000e+00
+};
+
+constexpr static const double ZIGGURAT_NORMAL_F[257] = {
+    4.77467764586655301e-04, 1.26028593049859797e-03, 2.60907274610636293e-03, 4.03797259337187152e-03,
+    5.52240329926475398e-03, 7.05087547139211009e-03, 8.61658276942291711e-03, 1.02149714397311003e-02,
+    1.18427578579431043e-02, 1.34974506017808069e-02, 1.51770883079820722e-02, 1.68800831525958393e-02,
+    1.86051212757833498e-02, 2.03510962301093543e-02, 2.21170627073799218e-02, 2.39022033058732368e-02,
+    2.57058040086326559e-02, 2.75272356696933153e-02, 2.93659397582301113e-02, 3.12214171920236899e-02,
+    3.30932194586886982e-02, 3.49809414618330733e-02, 3.68842156886911507e-02, 3.88027074046569179e-02,
+    4.07361106560787528e-02, 4.26841449166193779e-02, 4.46465522514465363e-02, 4.66230949020896637e-02,
+    4.86135532160351450e-02, 5.06177238611217883e-02, 5.26354182769736487e-02, 5.46664613250779155e-02,
+    5.67106901063994667e-02, 5.87679529211379836e-02, 6.08381083497518058e-02, 6.29210244379778544e-02,
+    6.50165779714704378e-02, 6.71246538280239891e-02, 6.92451443972502689e-02, 7.13779490591419652e-02,
+    7.35229737142409911e-02, 7.56801303591949637e-02, 7.78493367023722072e-02, 8.00305158149475088e-02,
+    8.22235958134956840e-02, 8.44285095706546612e-02, 8.66451944508677824e-02, 8.88735920685942288e-02,
+    9.11136480667007337e-02, 9.33653119130266190e-02, 9.56285367133533348e-02, 9.79032790392156266e-02,
+    1.00189498769172020e-01, 1.02487158942306270e-01, 1.04796225622867056e-01, 1.07116667775072880e-01,
+    1.09448457147210021e-01, 1.11791568164245583e-01, 1.14145977828255210e-01, 1.16511665626037014e-01,
+    1.18888613443345698e-01, 1.21276805485235437e-01, 1.23676228202051403e-01, 1.26086870220650349e-01,
+    1.28508722280473636e-01, 1.30941777174128166e-01, 1.33386029692162844e-01, 1.35841476571757352e-01,
+    1.38308116449064322e-01, 1.40785949814968309e-01, 1.43274978974047118e-01, 1.45775208006537926e-01,
+    1.48286642733128721e-01, 1.50809290682410169e-01, 1.53343161060837674e-01, 1.55888264725064563e-01,
+    1.58444614156520225e-01, 1.61012223438117663e-01, 1.63591108232982951e-01, 1.66181285765110071e-01,
+    1.68782774801850333e-01, 1.71395595638155623e-01, 1.74019770082499359e-01, 1.76655321444406654e-01,
+    1.79302274523530397e-01, 1.81960655600216487e-01, 1.84630492427504539e-01, 1.87311814224516926e-01,
+    1.90004651671193070e-01, 1.92709036904328807e-01, 1.95425003514885592e-01, 1.98152586546538112e-01,
+    2.00891822495431333e-01, 2.03642749311121501e-01, 2.06405406398679325e-01, 2.09179834621935651e-01,
+    2.11966076307852941e-01, 2.14764175252008499e-01, 2.17574176725178370e-01, 2.20396127481011589e-01,
+    2.23230075764789593e-01, 2.26076071323264877e-01, 2.28934165415577484e-01, 2.31804410825248525e-01,
+    2.34686861873252689e-01, 2.37581574432173676e-01, 2.40488605941449107e-01, 2.43408015423711988e-01,
+    2.46339863502238771e-01, 2.49284212419516704e-01, 2.52241126056943765e-01, 2.55210669955677150e-01,
+    2.58192911338648023e-01, 2.61187919133763713e-01, 2.64195763998317568e-01, 2.67216518344631837e-01,
+    2.70250256366959984e-01, 2.73297054069675804e-01, 2.76356989296781264e-01, 2.79430141762765316e-01,
+    2.82516593084849388e-01, 2.85616426816658109e-01, 2.88729728483353931e-01, 2.91856585618280984e-01,
+    2.94997087801162572e-01, 2.98151326697901342e-01, 3.01319396102034120e-01, 3.04501391977896274e-01,
+    3.07697412505553769e-01, 3.10907558127563710e-01, 3.14131931597630143e-01, 3.17370638031222396e-01,
+    3.20623784958230129e-01, 3.23891482377732021e-01, 3.27173842814958593e-01, 3.30470981380537099e-01,
+    3.33783015832108509e-01, 3.37110066638412809e-01, 3.40452257045945450e-01, 3.43809713148291340e-01,
+    3.47182563958251478e-01, 3.50570941482881204e-01, 3.53974980801569250e-01, 3.57394820147290515e-01,
+    3.60830600991175754e-01, 3.64282468130549597e-01, 3.67750569780596226e-01, 3.71235057669821344e-01,
+    3.74736087139491414e-01, 3.78253817247238111e-01, 3.81788410875031348e-01, 3.85340034841733958e-01,
+    3.88908860020464597e-01, 3.92495061461010764e-01, 3.96098818517547080e-01, 3.99720314981931668e-01,
+    4.03359739222868885e-01, 4.07017284331247953e-01, 4.10693148271983222e-01, 4.14387534042706784e-01,
+    4.18100649839684591e-01, 4.21832709231353298e-01, 4.25583931339900579e-01, 4.29354541031341519e-01,
+    4.33144769114574058e-01, 4.36954852549929273e-01, 4.40785034667769915e-01, 4.44635565397727750e-01,
+    4.48506701509214067e-01, 4.52398706863882505e-01, 4.56311852680773566e-01, 4.60246417814923481e-01,
+    4.64202689050278838e-01, 4.68180961407822172e-01, 4.72181538469883255e-01, 4.76204732721683788e-01,
+    4.80250865911249714e-01, 4.84320269428911598e-01, 4.88413284707712059e-01, 4.92530263646148658e-01,
+    4.96671569054796314e-01, 5.00837575128482149e-01, 5.05028667945828791e-01, 5.09245245998136142e-01,
+    5.13487720749743026e-01, 5.17756517232200619e-01, 5.22052074674794864e-01, 5.26374847174186700e-01,
+    5.30725304406193921e-01, 5.35103932383019565e-01, 5.39511234259544614e-01, 5.43947731192649941e-01,
+    5.48413963257921133e-01, 5.52910490428519918e-01, 5.57437893621486324e-01, 5.61996775817277916e-01,
+    5.66587763258951771e-01, 5.71211506738074970e-01, 5.75868682975210544e-01, 5.80559996103683473e-01,
+    5.85286179266300333e-01, 5.90047996335791969e-01, 5.94846243770991268e-01, 5.99681752622167719e-01,
+    6.04555390700549533e-01, 6.09468064928895381e-01, 6.14420723892076803e-01, 6.19414360609039205e-01,
+    6.24450015550274240e-01, 6.29528779928128279e-01, 6.34651799290960050e-01, 6.39820277456438991e-01,
+    6.45035480824251883e-01, 6.50298743114294586e-01, 6.55611470583224665e-01, 6.60975147780241357e-01,
+    6.66391343912380640e-01, 6.71861719900766374e-01, 6.77388036222513090e-01, 6.82972161648791376e-01,
+    6.88616083008527058e-01, 6.94321916130032579e-01, 7.00091918140490099e-01, 7.05928501336797409e-01,
+    7.11834248882358467e-01, 7.17811932634901395e-01, 7.23864533472881599e-01, 7.29995264565802437e-01,
+    7.36207598131266683e-01, 7.42505296344636245e-01, 7.48892447223726720e-01, 7.55373506511754500e-01,
+    7.61953346841546475e-01, 7.68637315803334831e-01, 7.75431304986138326e-01, 7.82341832659861902e-01,
+    7.89376143571198563e-01, 7.96542330428254619e-01, 8.03849483176389490e-01, 8.11307874318219935e-01,
+    8.18929191609414797e-01, 8.26726833952094231e-01, 8.34716292992930375e-01, 8.42915653118441077e-01,
+    8.51346258465123684e-01, 8.60033621203008636e-01, 8.69008688043793165e-01, 8.78309655816146839e-01,
+    8.87984660763399880e-01, 8.98095921906304051e-01, 9.08726440060562912e-01, 9.19991505048360247e-01,
+    9.32060075968990209e-01, 9.45198953453078028e-01, 9.59879091812415930e-01, 9.77101701282731328e-01,
+    1.00000000000000000e+00
+};
+
+constexpr static const double ZIGGURAT_EXP_X[257] = {
+    8.69711747013485237e+00, 7.69711747013148706e+00, 6.94103362937744794e+00, 6.47837849383273046e+00,
+    6.14416466577259524e+00, 5.88214431579549846e+00, 5.66641016745411630e+00, 5.48289062752613443e+00,
+    5.32309050575446108e+00, 5.18148728130155689e+00, 5.05428848998135560e+00, 4.93877708590129760e+00,
+    4.83293974102515467e+00, 4.73524299660178016e+00, 4.64449188542012159e+00, 4.55973706170738513e+00,
+    4.48021174652845389e+00, 4.40528769347360249e+00, 4.33444368031730054e+00, 4.26724248027739250e+00,
+    4.20331371373520923e+00, 4.14234086566407456e+00, 4.08405131040832003e+00, 4.02820854464795808e+00,
+    3.97460606667380922e+00, 3.92306250013550972e+00, 3.87341767039952822e+00, 3.82552941852235540e+00,
+    3.77927099241168607e+00, 3.73452889403981514e+00, 3.69120109023743570e+00, 3.64919551576087020e+00,
+    3.60842881312892549e+00, 3.56882526564835256e+00, 3.53031588912935890e+00, 3.49283765477407471e+00,
+    3.45633282113277485e+00, 3.42074835725113413e+00, 3.38603544246031518e+00, 3.35214903090012273e+00,
+    3.31904747097076092e+00, 3.28669217159908111e+00, 3.25504730857046187e+00, 3.22407956528627615e+00,
+    3.19375790321225228e+00, 3.16405335802598486e+00, 3.13493885808445194e+00, 3.10638906233983558e+00,
+    3.07838021525410133e+00, 3.05089001661546622e+00, 3.02389750445568728e+00, 2.99738294951614126e+00,
+    2.97132775992109988e+00, 2.94571439489505593e+00, 2.92052628651275059e+00, 2.89574776860015115e+00,
+    2.87136401201554570e+00, 2.84736096563519814e+00, 2.82372530245004461e+00, 2.80044437025074711e+00,
+    2.77750614643976590e+00, 2.75489919656235394e+00, 2.73261263619470940e+00, 2.71063609586793763e+00,
+    2.68895968874181213e+00, 2.66757398077327501e+00, 2.64646996315181715e+00, 2.62563902679779648e+00,
+    2.60507293874084356e+00, 2.58476382021414874e+00, 2.56470412631691325e+00, 2.54488662711187796e+00,
+    2.52530439003783558e+00, 2.50595076352860158e+00, 2.48681936174021745e+00, 2.46790405029737281e+00,
+    2.44919893297825775e+00, 2.43069833926442769e+00, 2.41239681268887862e+00, 2.39428909992146588e+00,
+    2.37637014053614815e+00, 2.35863505740934487e+00, 2.34107914770304193e+00, 2.32369787439020348e+00,
+    2.30648685828358690e+00, 2.28944187053227655e+00, 2.27255882555316191e+00, 2.25583377436722632e+00,
+    2.23926289831291569e+00, 2.22284250311104303e+00, 2.20656901325767008e+00, 2.19043896672322624e+00,
+    2.17444900993778090e+00, 2.15859589304389221e+00, 2.14287646539984822e+00, 2.12728767131737451e+00,
+    2.11182654601904840e+00, 2.09649021180172124e+00, 2.08127587439323136e+00, 2.06618081949058219e+00,
+    2.05120240946859145e+00, 2.03633808024877583e+00, 2.02158533831893239e+00, 2.00694175789452434e+00,
+    1.99240497821358242e+00, 1.97797270095736621e+00, 1.96364268778955386e+00, 1.94941275800719049e+00,
+    1.93528078629705691e+00, 1.92124470059153341e+00, 1.90730248001839264e+00, 1.89345215293931335e+00,
+    1.87969179507221629e+00, 1.86601952769283308e+00, 1.85243351591118066e+00, 1.83893196701888484e+00,
+    1.82551312890352446e+00, 1.81217528852639531e+00, 1.79891677046029552e+00, 1.78573593548413045e+00,
+    1.77263117923130986e+00, 1.75960093088907898e+00, 1.74664365194607862e+00, 1.73375783498557601e+00,
+    1.72094200252193974e+00, 1.70819470587806221e+00, 1.69551452410154235e+00, 1.68290006291755834e+00,
+    1.67034995371645656e+00, 1.65786285257417720e+00, 1.64543743930372810e+00, 1.63307241653599600e+00,
+    1.62076650882826234e+00, 1.60851846179886282e+00, 1.59632704128648784e+00, 1.58419103253269333e+00,
+    1.57210923938623415e+00, 1.56008048352789253e+00, 1.54810360371451794e+00, 1.53617745504103653e+00,
+    1.52430090821923070e+00, 1.51247284887212152e+00, 1.50069217684282119e+00, 1.48895780551675028e+00,
+    1.47726866115613809e+00, 1.46562368224574957e+00, 1.45402181884879766e+00, 1.44246203197201672e+00,
+    1.43094329293888389e+00, 1.41946458276998744e+00, 1.40802489156953992e+00, 1.39662321791704636e+00,
+    1.38525856826312643e+00, 1.37392995632849502e+00, 1.36263640250509122e+00, 1.35137693325833963e+00,
+    1.34015058052950908e+00, 1.32895638113712100e+00, 1.31779337617632919e+00, 1.30666061041517856e+00,
+    1.29555713168660525e+00, 1.28448199027501708e+00, 1.27343423829624558e+00, 1.26241292906961977e+00,
+    1.25141711648085696e+00, 1.24044585433441101e+00, 1.22949819569385377e+00, 1.21857319220879479e+00,
+    1.20766989342676578e+00, 1.19678734608840776e+00, 1.18592459340420708e+00, 1.17508067431091634e+00,
+    1.16425462270568381e+00, 1.15344546665577941e+00, 1.14265222758167750e+00, 1.13187391941108340e+00,
+    1.12110954770133531e+00, 1.11035810872741592e+00, 1.09961858853260219e+00, 1.08888996193855170e+00,
+    1.07817119151137697e+00, 1.06746122647997232e+00, 1.05675900160255609e+00, 1.04606343597704887e+00,
+    1.03537343179053321e+00, 1.02468787300262210e+00, 1.01400562395710137e+00, 1.00332552791570162e+00,
+    9.92646405507280671e-01, 9.81967053085067265e-01, 9.71286240983908145e-01, 9.60602711668671283e-01,
+    9.49915177764080854e-01, 9.39222319955267282e-01, 9.28522784747215391e-01, 9.17815182070049085e-01,
+    9.07098082715695253e-01, 8.96370015589894931e-01, 8.85629464761756413e-01, 8.74874866291030062e-01,
+    8.64104604811009369e-01, 8.53317009842378238e-01, 8.42510351810373592e-01, 8.31682837734278202e-01,
+    8.20832606554416810e-01, 8.09957724057423278e-01, 7.99056177355492170e-01, 7.88125868869497648e-01,
+    7.77164609759134817e-01, 7.66170112735439668e-01, 7.55139984181987245e-01, 7.44071715500513098e-01,
+    7.32962673584370394e-01, 7.21810090308761310e-01, 7.10611050909660147e-01, 6.99362481103237177e-01,
+    6.88061132773753137e-01, 6.76703568029527913e-01, 6.65286141392683050e-01, 6.53804979847670276e-01,
+    6.42255960424541694e-01, 6.30634684933495726e-01, 6.18936451394881404e-01, 6.07156221620305581e-01,
+    5.95288584291508327e-01, 5.83327712748774929e-01, 5.71267316532593661e-01, 5.59100585511545844e-01,
+    5.46820125163315685e-01, 5.34417881237170933e-01, 5.21885051592140492e-01, 5.09211982443659839e-01,
+    4.96388045518676435e-01, 4.83401491653467075e-01, 4.70239275082174335e-01, 4.56886840931425620e-01,
+    4.43327866073557952e-01, 4.29543940225416310e-01, 4.15514169600362138e-01, 4.01214678896283594e-01,
+    3.86617977941125457e-01, 3.71692145329923174e-01, 3.56399760258399811e-01, 3.40696481064855394e-01,
+    3.24529117016915891e-01, 3.07832954674938930e-01, 2.90527955491237555e-01, 2.72513185478472142e-01,
+    2.53658363385919794e-01, 2.33790483059682863e-01, 2.12671510630975280e-01, 1.89958689622441251e-01,
+    1.65127622564197635e-01, 1.37304980940024413e-01, 1.04838507565832947e-01, 6.38521638150206239e-02,
+    0.00000000000000000e+00
+};
+
+constexpr static const double ZIGGURAT_EXP_F[257] = {
+    1.67066692307328574e-04, 4.54134353841298139e-04, 9.67269282326946637e-04, 1.53629978030132559e-03,
+    2.14596774371864389e-03, 2.78879879357380074e-03, 3.46026477783661825e-03, 4.15729512083349781e-03,
+    4.87765598354208789e-03, 5.61964220720516903e-03, 6.38190593731885469e-03, 7.16335318363465340e-03,
+    7.96307743801670347e-03, 8.78031498580863351e-03, 9.61441364250186295e-03, 1.04648101810296285e-02,
+    1.13310135978342379e-02, 1.22125924262550204e-02, 1.31091649312546302e-02, 1.40203914031815681e-02,
+    1.49459680116907773e-02, 1.58856218399727918e-02, 1.68391068260395661e-02, 1.78062004109109766e-02,
+    1.87867007446956384e-02, 1.97804243380093440e-02, 2.07872040725777182e-02, 2.18068875042831747e-02,
+    2.28393354063848239e-02, 2.38844205115577510e-02, 2.49420264197313668e-02, 2.60120466451337941e-02,
+    2.70943837809553695e-02, 2.81889487639782055e-02, 2.92956602246369525e-02, 3.04144439104661636e-02,
+    3.15452321728931645e-02, 3.26879635089590906e-02, 3.38425821508738789e-02, 3.50090376973969664e-02,
+    3.61872847819309784e-02, 3.73772827729589169e-02, 3.85789955030744064e-02, 3.97923910233736605e-02,
+    4.10174413804143476e-02, 4.22541224133157478e-02, 4.35024135688876976e-02, 4.47622977329427893e-02,
+    4.60337610761746702e-02, 4.73167929131810411e-02, 4.86113855733789832e-02, 4.99175342827058444e-02,
+    5.12352370551257541e-02, 5.25644945930711510e-02, 5.39053101960455527e-02, 5.52576896766965170e-02,
+    5.66216412837423425e-02, 5.79971756312001180e-02, 5.93843056334197247e-02, 6.07830464454790914e-02,
+    6.21934154085404534e-02, 6.36154319998067791e-02, 6.50491177867531939e-02, 6.64944963853392329e-02,
+    6.79515934219360601e-02, 6.94204364987281997e-02, 7.09010551623712737e-02, 7.23934808757081688e-02,
+    7.38977469923641495e-02, 7.54138887340577990e-02, 7.69419431704799067e-02, 7.84819492016058107e-02,
+    8.00339475423192948e-02, 8.15979807092367948e-02, 8.31740930096317305e-02, 8.47623305323674664e-02,
+    8.63627411407562329e-02, 8.79753744672695376e-02, 8.96002819100321646e-02, 9.12375166310394753e-02,
+    9.28871335560428613e-02, 9.45491893760551511e-02, 9.62237425504321037e-02, 9.79108533114915053e-02,
+    9.96105836706364239e-02, 1.01322997425952910e-01, 1.03048160171256967e-01, 1.04786139306569409e-01,
+    1.06537004050000925e-01, 1.08300825451033075e-01, 1.10077676405184677e-01, 1.11867631670055589e-01,
+    1.13670767882743579e-01, 1.15487163578632784e-01, 1.17316899211554804e-01, 1.19160057175326906e-01,
+    1.21016721826674042e-01, 1.22886979509544345e-01, 1.24770918580830156e-01, 1.26668629437509811e-01,
+    1.28580204545227339e-01, 1.30505738468329968e-01, 1.32445327901386689e-01, 1.34399071702212825e-01,
+    1.36367070926428052e-01, 1.38349428863579399e-01, 1.40346251074861622e-01, 1.42357645432471369e-01,
+    1.44383722160633915e-01, 1.46424593878344111e-01, 1.48480375643865958e-01, 1.50551185001039062e-01,
+    1.52637142027442024e-01, 1.54738369384467223e-01, 1.56854992369364371e-01, 1.58987138969313352e-01,
+    1.61134939917591175e-01, 1.63298528751900957e-01, 1.65478041874935172e-01, 1.67673618617249359e-01,
+    1.69885401302526828e-01, 1.72113535315319227e-01, 1.74358169171352662e-01, 1.76619454590494052e-01,
+    1.78897546572477473e-01, 1.81192603475495456e-01, 1.83504787097766603e-01, 1.85834262762196251e-01,
+    1.88181199404253430e-01, 1.90545769663194503e-01, 1.92928149976770436e-01, 1.95328520679562301e-01,
+    1.97747066105097957e-01, 2.00183974691910321e-01, 2.02639439093708074e-01, 2.05113656293836766e-01,
+    2.07606827724221066e-01, 2.10119159388987287e-01, 2.12650861992977280e-01, 2.15202151075377685e-01,
+    2.17773247148699500e-01, 2.20364375843358440e-01, 2.22975768058119139e-01, 2.25607660116683012e-01,
+    2.28260293930715646e-01, 2.30933917169626385e-01, 2.33628783437432291e-01, 2.36345152457058588e-01,
+    2.39083290262448095e-01, 2.41843469398876104e-01, 2.44625969131890997e-01, 2.47431075665326489e-01,
+    2.50259082368861130e-01, 2.53110290015628292e-01, 2.55985007030414158e-01, 2.58883549749015007e-01,
+    2.61806242689361757e-01, 2.64753418835060983e-01, 2.67725419932043573e-01, 2.70722596799058801e-01,
+    2.73745309652801749e-01, 2.76793928448516080e-01, 2.79868833236971648e-01, 2.82970414538779524e-01,
+    2.86099073737075549e-01, 2.89255223489676416e-01, 2.92439288161891242e-01, 2.95651704281259864e-01,
+    2.98892921015580404e-01, 3.02163400675692140e-01, 3.05463619244588813e-01, 3.08794066934558742e-01,
+    3.12155248774178107e-01, 3.15547685227127506e-01, 3.18971912844955741e-01, 3.22428484956087613e-01,
+    3.25917972393554689e-01, 3.29440964264134828e-01, 3.32998068761807431e-01, 3.36589914028676107e-01,
+    3.40217149066778579e-01, 3.43880444704501020e-01, 3.47580494621635483e-01, 3.51318016437481839e-01,
+    3.55093752866785961e-01, 3.58908472948748225e-01, 3.62762973354816221e-01, 3.66658079781512602e-01,
+    3.70594648435144447e-01, 3.74573567615900604e-01, 3.78595759409579236e-01, 3.82662181496008225e-01,
+    3.86773829084136045e-01, 3.90931736984795442e-01, 3.95136981833288492e-01, 3.99390684475229407e-01,
+    4.03694012530528556e-01, 4.08048183152030675e-01, 4.12454465997159458e-01, 4.16914186433001155e-01,
+    4.21428728997614854e-01, 4.25999541143032567e-01, 4.30628137288457002e-01, 4.35316103215634742e-01,
+    4.40065100842352008e-01, 4.44876873414546625e-01, 4.49753251162753054e-01, 4.54696157474613505e-01,
+    4.59707615642135692e-01, 4.64789756250424180e-01, 4.69944825283957979e-01, 4.75175193037375321e-01,
+    4.80483363930452156e-01, 4.85871987341882805e-01, 4.91343869594030369e-01, 4.96901987241547327e-01,
+    5.02549501841345392e-01, 5.08289776410640548e-01, 5.14126393814746230e-01, 5.20063177368231155e-01,
+    5.26104213983617286e-01, 5.32253880263040768e-01, 5.38516872002859359e-01, 5.44898237672437058e-01,
+    5.51403416540638736e-01, 5.58038282262584895e-01, 5.64809192912397617e-01, 5.71723048664823152e-01,
+    5.78787358602842361e-01, 5.86010318477265257e-01, 5.93400901691730542e-01, 6.00968966365229340e-01,
+    6.08725382079619126e-01, 6.16682180915204659e-01, 6.24852738703662869e-01, 6.33251994214362957e-01,
+    6.41896716427262870e-01, 6.50805833414567769e-01, 6.60000841078996370e-01, 6.69506316731921292e-01,
+    6.79350572264761809e-01, 6.89566496117074323e-01, 7.00192655082784388e-01, 7.11274760805072015e-01,
+    7.22867659593567802e-01, 7.35038092431419043e-01, 7.47868621985190329e-01, 7.61463388849891176e-01,
+    7.75956852040110223e-01, 7.91527636972489845e-01, 8.08421651523002049e-01, 8.26993296643043330e-01,
+    8.47785500623981725e-01, 8.71704332381194380e-01, 9.00469929925734935e-01, 9.38143680862158602e-01,
+    1.00000000000000000e+00
+};
+
+/* Uniform in (0, 1), for taking logarithms. */
+static inline double u64_to_open_double(const std::uint64_t x)
+{
+    return (static_cast<double>(x >> 12) + 0.5) * (1.0 / 4503599627370496.0);
+}
+
+/* Standard normal and exponential variates, from the ziggurat tables above.
+   Each variate starts from one 64-bit draw 'bits', whose lowest 8 bits pick
+   the layer and whose highest 53 give the position inside it; that first
+   step ('fast') is accepted around 99% of the times, and the rest go through
+   'slow', which starts from the same draw and takes further ones from 'src'
+   as needed (for the tails and the wedges). */
+struct ZigguratNormal
+{
+    static inline bool fast(const std::uint64_t bits, double &x)
+    {
+        const int i = static_cast<int>(bits & 0xff);
+        const double u = static_cast<double>(static_cast<std::int64_t>(bits) >> 11) * (1.0 / 4503599627370496.0);
+        x = u * ZIGGURAT_NORMAL_X[i];
+        return std::fabs(x) < ZIGGURAT_NORMAL_X[i + 1];
+    }
+
+    template <class src_t>
+    static inline double slow(std::uint64_t bits, src_t &src)
+    {
+        for (;;)
+        {
+            double x;
+            if (fast(bits, x)) return x;
+            const int i = static_cast<int>(bits & 0xff);
+            if (i == 0)
+            {
+                double tail, y;
+                do
+                {
+                    tail = std::log(u64_to_open_double(random_u64(src))) / ZIGGURAT_NORMAL_R;
+                    y = std::log(u64_to_open_double(random_u64(src)));
+                } while (-2.0 * y < tail * tail);
+                return (x < 0)? (tail - ZIGGURAT_NORMAL_R) : (ZIGGURAT_NORMAL_R - tail);
+            }
+            const double f = ZIGGURAT_NORMAL_F[i + 1]
+                + (ZIGGURAT_NORMAL_F[i] - ZIGGURAT_NORMAL_F[i + 1]) * u64_to_double(random_u64(src));
+            if (f < std::exp(-0.5 * x * x)) return x;
+            bits = random_u64(src);
+        }
+    }
+};
+
+struct ZigguratExponential
+{
+    static inline bool fast(const std::uint64_t bits, double &x)
+    {
+        const int i = static_cast<int>(bits & 0xff);
+        x = u64_to_double(bits) * ZIGGURAT_EXP_X[i];
+        return x < ZIGGURAT_EXP_X[i + 1];
+    }
+
+    template <class src_t>
+    static inline double slow(std::uint64_t bits, src_t &src)
+    {
+        for (;;)
+        {
+            double x;
+            if (fast(bits, x)) return x;
+            const int i = static_cast<int>(bits & 0xff);
+            if (i == 0)
+                return ZIGGURAT_EXP_R - std::log(u64_to_open_double(random_u64(src)));
+            const double f = ZIGGURAT_EXP_F[i + 1]
+                + (ZIGGURAT_EXP_F[i] - ZIGGURAT_EXP_F[i + 1]) * u64_to_double(random_u64(src));
+            if (f < std::exp(-x)) return x;
+            bits = random_u64(src);
+        }
+    }
+};
+
+/* Draws of 'n' 64-bit values from an engine with 64-bit outputs, or from
+   two outputs each (the first giving the highest bits) for 32-bit ones. */
+template <class rng_t>
+static inline void fill_u64(rng_t &rng, std::uint64_t *out, const std::size_t n, std::true_type)
+{
+    rng.fill(out, n);
+}
+
+template <class rng_t>
+static inline void fill_u64(rng_t &rng, std::uint64_t *out, const std::size_t n, std::false_type)
+{
+    constexpr std::size_t block = 128;
+    typename rng_t::result_type raw[2 * block];
+    for (std::size_t start = 0; start < n; start += block)
+    {
+        const std::size_t n_block = (n - start < block)? (n - start) : block;
+        rng.fill(raw, 2 * n_block);
+        for (std::size_t ix = 0; ix < n_block; ix++)
+            out[start + ix] = (static_cast<std::uint64_t>(raw[2*ix]) << 32) | static_cast<std::uint64_t>(raw[2*ix + 1]);
+    }
+}
+
+template <class rng_t>
+static inline void fill_u64(rng_t &rng, std::uint64_t *out, const std::size_t n)
+{
+    fill_u64(rng, out, n, std::integral_constant<bool, sizeof(typename rng_t::result_type) == sizeof(std::uint64_t)>());
+}
+
+/* 64-bit values handed out one at a time from blocks filled with 'fill_u64',
+   for taking single values from engines that only produce them in bulk. */
+template <class rng_t>
+class RawBlock
+{
+public:
+    using result_type = std::uint64_t;
+
+    explicit RawBlock(rng_t &rng) : rng(rng) {}
+
+    result_type operator()()
+    {
+        if (this->pos == N)
+        {
+            fill_u64(this->rng, this->values, N);
+            this->pos = 0;
+        }
+        return this->values[this->pos++];
+    }
+
+private:
+    constexpr static const std::size_t N = 64;
+    rng_t &rng;
+    std::size_t pos = N;
+    std::uint64_t values[N];
+};
+
+/* Fills 'out' with 'shift + scale*z', 'z' being the variates of 'Ziggurat'.
+   Draws are made in blocks with 'fill_u64', so that when 'rng' is a
+   'XoshiroLanes' they come from the vectorized engine, then the fast step is
+   applied to the whole block in a branch-free loop that compilers can
+   vectorize (with gathers for the table lookups), and only the rejected
+   entries are redone one by one. */
+template <class Ziggurat, class rng_t, class real_t>
+static inline void fill_ziggurat(rng_t &rng, real_t *out, const std::size_t n, const double shift, const double scale)
+{
+    constexpr std::size_t block = 256;
+    alignas(64) std::uint64_t raw[block];
+    alignas(64) double values[block];
+    bool accepted[block];
+    RawBlock<rng_t> extra(rng);
+    for (std::size_t start = 0; start < n; start += block)
+    {
+        const std::size_t n_block = (n - start < block)? (n - start) : block;
+        fill_u64(rng, raw, n_block);
+        for (std::size_t ix = 0; ix < n_block; ix++)
+            accepted[ix] = Ziggurat::fast(raw[ix], values[ix]);
+        for (std::size_t ix = 0; ix < n_block; ix++)
+            if (!accepted[ix])
+                values[ix] = Ziggurat::slow(raw[ix], extra);
+        for (std::size_t ix = 0; ix < n_block; ix++)
+            out[start + ix] = static_cast<real_t>(shift + scale * values[ix]);
+    }
+}
+
+/* One standard normal / exponential (rate 1) variate from any of the engines. */
+template <class rng_t>
+static inline double ziggurat_normal(rng_t &rng)
+{
+    return ZigguratNormal::slow(random_u64(rng), rng);
+}
+
+template <class rng_t>
+static inline double ziggurat_exponential(rng_t &rng)
+{
+    return ZigguratExponential::slow(random_u64(rng), rng);
+}
+
+/* Fills 'out' (of 'float' or 'double') with 'n' normal variates of the given
+   mean and standard deviation, or exponential variates of the given rate.
+   'rng' can be a scalar engine or a 'XoshiroLanes'. */
+template <class rng_t, class real_t>
+static inline void fill_normal(rng_t &rng, real_t *out, const std::size_t n,
+                               const double mean = 0, const double stddev = 1)
+{
+    fill_ziggurat<ZigguratNormal>(rng, out, n, mean, stddev);
+}
+
+template <class rng_t, class real_t>
+static inline void fill_exponential(rng_t &rng, real_t *out, const std::size_t n, const double rate = 1)
+{
+    fill_ziggurat<ZigguratExponential>(rng, out, n, 0.0, 1.0 / rate);
+}
+
+/* Packed Bernoulli masks: every bit of the 'n_words' words written to 'out'
+   is set independently with the given probability ('rng' can be a scalar
+   engine or a 'XoshiroLanes'). */
+
+/* Probability 1/2: the raw outputs, one draw per 64 bits. */
+template <class rng_t>
+static inline void fill_bits(rng_t &rng, std::uint64_t *out, const std::size_t n_words)
+{
+    fill_u64(rng, out, n_words);
+}
+
+/* Probability k/2^m, exactly. The binary digits of 'k' are read from the
+   lowest set one upwards, each one combining the mask with a new draw by OR
+   (digit 1, P -> (1 + P)/2) or by AND (digit 0, P -> P/2), so that each word
+   costs 'm - ctz(k)' draws, e.g. 2 for p = 1/4 or p = 3/4. For m > 64 the
+   digits of 'k' past the 64th are zeros, i.e. one more AND each. */
+template <class rng_t>
+static inline void fill_bernoulli_dyadic(rng_t &rng, std::uint64_t *out, const std::size_t n_words,
+                                         std::uint64_t k, unsigned m)
+{
+    while (k != 0 && (k & 1) == 0 && m > 0)
+    {
+        k >>= 1;
+        m--;
+    }
+    if (k == 0 || (m < 64 && (k >> m) != 0))
+    {
+        std::fill(out, out + n_words, (k == 0)? std::uint64_t(0) : ~std::uint64_t(0));
+        return;
+    }
+
+    constexpr std::size_t block = 64;
+    alignas(64) std::uint64_t raw[block];
+    for (std::size_t start = 0; start < n_words; start += block)
+    {
+        const std::size_t n_block = (n_words - start < block)? (n_words - start) : block;
+        std::uint64_t *dst = out + start;
+        fill_u64(rng, dst, n_block);
+        for (unsigned j = 1; j < m; j++)
+        {
+            fill_u64(rng, raw, n_block);
+            if (j < 64 && ((k >> j) & 1))
+                for (std::size_t ix = 0; ix < n_block; ix++)
+                    dst[ix] |= raw[ix];
+            else
+                for (std::size_t ix = 0; ix < n_block; ix++)
+                    dst[ix] &= raw[ix];
+        }
+    }
+}
+
+/* Any probability 'p'. When 'p' is a multiple of 2^-64 (which every double
+   in [2^-11, 1] is), it is done exactly by 'fill_bernoulli_dyadic' with at
+   most 64 draws per word. Otherwise each bit compares one 64-bit draw with
+   'p * 2^64'; the comparisons run across the words of a block, in a
+   branch-free loop that compilers can vectorize. */
+template <class rng_t>
+static inline void fill_bernoulli(rng_t &rng, std::uint64_t *out, const std::size_t n_words, const double p)
+{
+    if (!(p > 0.0) || p >= 1.0)
+    {
+        std::fill(out, out + n_words, (p >= 1.0)? ~std::uint64_t(0) : std::uint64_t(0));
+        return;
+    }
+    const double scaled = std::ldexp(p, 64);
+    if (scaled == std::floor(scaled))
+    {
+        fill_bernoulli_dyadic(rng, out, n_words, static_cast<std::uint64_t>(scaled), 64);
+        return;
+    }
+
+    const std::uint64_t threshold = static_cast<std::uint64_t>(scaled);
+    constexpr std::size_t block = 16;
+    alignas(64) std::uint64_t raw[64 * block];
+    for (std::size_t start = 0; start < n_words; start += block)
+    {
+        const std::size_t n_block = (n_words - start < block)? (n_words - start) : block;
+        fill_u64(rng, raw, 64 * block);
+        alignas(64) std::uint64_t words[block] = {};
+        for (unsigned j = 0; j < 64; j++)
+            for (std::size_t w = 0; w < block; w++)
+                words[w] |= static_cast<std::uint64_t>(raw[j * block + w] < threshold) << j;
+        std::memcpy(out + start, words, n_block * sizeof(std::uint64_t));
+    }
+}
+
+/* Seeds 'out[ix]' as 'out[ix].seed(keys[ix])' would, for 'ix' in [0, n).
+   With AVX-512DQ or AVX2 the splitmix64 chains of 'SEED_BLOCK' keys are
+   advanced together, one state word at a time, with vector instructions;
+   otherwise the generators are seeded one by one, which is as fast without
+   vector 64-bit multiplications. */
+constexpr static const std::size_t SEED_BLOCK = 16;
+
+/* 'z[b] = splitmix64(z[b])' for the 'SEED_BLOCK' words of 'z'. Compilers
+   vectorize the plain loop with AVX-512DQ; AVX2 has no 64-bit multiplication,
+   so the products are put together from 32-bit ones. */
+static inline void splitmix64_block(std::uint64_t z[SEED_BLOCK])
+{
+#if defined(__AVX2__) && !defined(__AVX512DQ__)
+    const __m256i increment = _mm256_set1_epi64x(static_cast<long long>(0x9e3779b97f4a7c15));
+    const __m256i m1_lo = _mm256_set1_epi64x(0x1ce4e5b9);
+    const __m256i m1_hi = _mm256_set1_epi64x(0xbf58476d);
+    const __m256i m2_lo = _mm256_set1_epi64x(0x133111eb);
+    const __m256i m2_hi = _mm256_set1_epi64x(0x94d049bb);
+    const auto mul = [](const __m256i a, const __m256i b_lo, const __m256i b_hi)
+    {
+        const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b_lo),
+                                               _mm256_mul_epu32(a, b_hi));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b_lo), _mm256_slli_epi64(cross, 32));
+    };
+    for (std::size_t b = 0; b < SEED_BLOCK; b += 4)
+    {
+        __m256i v = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(z + b)), increment);
+        v = mul(_mm256_xor_si256(v, _mm256_srli_epi64(v, 30)), m1_lo, m1_hi);
+        v = mul(_mm256_xor_si256(v, _mm256_srli_epi64(v, 27)), m2_lo, m2_hi);
+        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 31));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(z + b), v);
+    }
+#else
+    for (std::size_t b = 0; b < SEED_BLOCK; b++)
+        z[b] = splitmix64(z[b]);
+#endif
+}
+
+template <class rng_t>
+static inline void seed_many(const std::uint64_t *keys, rng_t *out, const std::size_t n, std::true_type)
+{
+    for (std::size_t start = 0; start < n; start += SEED_BLOCK)
+    {
+        const std::size_t n_block = (n - start < SEED_BLOCK)? (n - start) : SEED_BLOCK;
+        alignas(64) std::uint64_t z[SEED_BLOCK] = {};
+        std::memcpy(z, keys + start, n_block * sizeof(std::uint64_t));
+        alignas(64) std::uint64_t words[rng_t::state_words][SEED_BLOCK];
+        splitmix64_block(z);
+        for (int ix = 0; ix < rng_t::state_words; ix++)
+        {
+            splitmix64_block(z);
+            std::memcpy(words[ix], z, sizeof(z));
+        }
+        for (std::size_t b = 0; b < n_block; b++)
+            for (int ix = 0; ix < rng_t::state_words; ix++)
+                out[start + b].state[ix] = words[ix][b];
+    }
+}
+
+template <class rng_t>
+static inline void seed_many(const std::uint64_t *keys, rng_t *out, const std::size_t n, std::false_type)
+{
+    for (std::size_t start = 0; start < n; start += SEED_BLOCK)
+    {
+        const std::size_t n_block = (n - start < SEED_BLOCK)? (n - start) : SEED_BLOCK;
+        alignas(64) std::uint64_t z[SEED_BLOCK] = {};
+        alignas(64) std::uint64_t words[rng_t::state_words][SEED_BLOCK];
+        std::memcpy(z, keys + start, n_block * sizeof(std::uint64_t));
+        for (int ix = 0; ix < rng_t::state_words; ix += 2)
+        {
+            splitmix64_block(z);
+            for (std::size_t b = 0; b < SEED_BLOCK; b++)
+            {
+                words[ix][b] = extract_32bits_from64_left(z[b]);
+                words[ix + 1][b] = extract_32bits_from64_right(z[b]);
+            }
+            splitmix64_block(words[ix]);
+            splitmix64_block(words[ix + 1]);
+        }
+        for (std::size_t b = 0; b < n_block; b++)
+            for (int ix = 0; ix < rng_t::state_words; ix++)
+                out[start + b].state[ix] = static_cast<typename rng_t::result_type>(words[ix][b]);
+    }
+}
+
+template <class rng_t>
+static inline void seed_many(const std::uint64_t *keys, rng_t *out, const std::size_t n)
+{
+#if defined(__AVX512DQ__) || defined(__AVX2__)
+    seed_many(keys, out, n, std::integral_constant<bool, sizeof(typename rng_t::result_type) == sizeof(std::uint64_t)>());
+#else
+    for (std::size_t ix = 0; ix < n; ix++)
+        out[ix].seed(keys[ix]);
+#endif
+}
+
+/* A seed sequence for the 'seed(Sseq&)' functions and constructors that only
+   holds one 64-bit key, so that it neither allocates nor hashes a buffer like
+   'std::seed_seq' does. 'generate' gives the two halves of consecutive
+   splitmix64 outputs, in the order for which a generator with 64-bit words
+   gets the same state as with 'seed(key)'. It provides only what the
+   generators use, not the whole SeedSequence interface. */
+class SplitMixSeedSeq
+{
+public:
+    using result_type = std::uint32_t;
+
+    SplitMixSeedSeq() = default;
+
+    explicit SplitMixSeedSeq(const std::uint64_t key) : key(key) {}
+
+    template <class RandomIt>
+    void generate(RandomIt first, RandomIt last) const
+    {
+        std::uint64_t z = splitmix64(this->key);
+        while (first != last)
+        {
+            z = splitmix64(z);
+            *first++ = extract_32bits_from64_left(z);
+            if (first == last) break;
+            *first++ = extract_32bits_from64_right(z);
+        }
+    }
+
+    std::uint64_t get_key() const
+    {
+        return this->key;
+    }
+
+private:
+    std::uint64_t key = 0;
+};
+
+/* Pools of generators saved as one array: the states of 'n' generators one
+   after the other in the layout of 'save', 'n * rng_t::state_bytes' bytes in
+   total. On little-endian hosts this is also the layout of an array of
+   'rng_t' in memory, so 'save_pool' and 'load_pool' are one copy. */
+template <class rng_t>
+static inline void save_pool(const rng_t *rngs, const std::size_t n, unsigned char *out)
+{
+    if (sizeof(rng_t) == rng_t::state_bytes && n > 0)
+    {
+        store_le(out, &rngs[0].state[0], n*rng_t::state_words);
+        return;
+    }
+    for (std::size_t ix = 0; ix < n; ix++)
+        rngs[ix].save(out + ix*rng_t::state_bytes);
+}
+
+template <class rng_t>
+static inline void load_pool(const unsigned char *in, const std::size_t n, rng_t *rngs)
+{
+    if (sizeof(rng_t) == rng_t::state_bytes && n > 0)
+    {
+        load_le(&rngs[0].state[0], in, n*rng_t::state_words);
+        return;
+    }
+    for (std::size_t ix = 0; ix < n; ix++)
+        rngs[ix].load(in + ix*rng_t::state_bytes);
+}
+
+/* Uses a saved pool in place (e.g. a memory-mapped checkpoint, aligned for
+   'rng_t') as an array of 'n' generators, without copying or parsing it.
+   On big-endian hosts the words are first converted in place, and the pool
+   has to be converted back with 'pool_unview' before being saved again;
+   on little-endian hosts both are no-ops. */
+template <class rng_t>
+static inline rng_t* pool_view(void *bytes, const std::size_t n)
+{
+    static_assert(sizeof(rng_t) == rng_t::state_bytes && std::is_trivially_copyable<rng_t>::value,
+                  "the generators must have no other members than the state");
+    using word_t = typename rng_t::result_type;
+    word_t *words = static_cast<word_t*>(bytes);
+#if !XOSHIRO_LITTLE_ENDIAN
+    load_le(words, static_cast<const unsigned char*>(bytes), n*rng_t::state_words);
+#else
+    (void)n;
+#endif
+    return reinterpret_cast<rng_t*>(words);
+}
+
+template <class rng_t>
+static inline void pool_unview(rng_t *rngs, const std::size_t n)
+{
+#if !XOSHIRO_LITTLE_ENDIAN
+    store_le(reinterpret_cast<unsigned char*>(rngs), &rngs[0].state[0], n*rng_t::state_words);
+#else
+    (void)rngs;
+    (void)n;
+#endif
+}
+
+/* Versioned format for exchanging generators between hosts: a 16-byte header,
+   then the states in the layout of 'save_pool' (so that encoding and decoding
+   are one copy on little-endian hosts). The header holds the bytes "XSHR",
+   the format version (16 bits), the 'wire_tag' of the generator class (16
+   bits) and the number of states (64 bits), all little-endian. */
+constexpr static const std::uint16_t WIRE_VERSION = 1;
+constexpr static const std::size_t WIRE_HEADER_BYTES = 16;
+
+struct WireHeader
+{
+    std::uint16_t version;
+    std::uint16_t tag;
+    std::uint64_t count;
+};
+
+/* Bytes taken by 'n' generators of type 'rng_t'. */
+template <class rng_t>
+static inline std::size_t wire_size(const std::size_t n)
+{
+    return WIRE_HEADER_BYTES + n*rng_t::state_bytes;
+}
+
+/* Writes 'n' generators to 'out', which must have room for 'wire_size(n)'
+   bytes, and returns the number of bytes written. */
+template <class rng_t>
+static inline std::size_t encode_wire(const rng_t *rngs, const std::size_t n, unsigned char *out)
+{
+    const std::uint16_t header[2] = {WIRE_VERSION, rng_t::wire_tag};
+    const std::uint64_t count = n;
+    std::memcpy(out, "XSHR", 4);
+    store_le(out + 4, header, 2);
+    store_le(out + 8, &count, 1);
+    save_pool(rngs, n, out + WIRE_HEADER_BYTES);
+    return wire_size<rng_t>(n);
+}
+
+/* Reads the header of 'size' bytes of encoded generators, for finding out
+   their type and number. Returns false if they are not in this format (or
+   in a newer version of it). */
+static inline bool read_wire_header(const unsigned char *in, const std::size_t size, WireHeader &header)
+{
+    if (size < WIRE_HEADER_BYTES || std::memcmp(in, "XSHR", 4) != 0)
+        return false;
+    std::uint16_t fields[2];
+    load_le(fields, in + 4, 2);
+    load_le(&header.count, in + 8, 1);
+    header.version = fields[0];
+    header.tag = fields[1];
+    return header.version >= 1 && header.version <= WIRE_VERSION;
+}
+
+/* Reads generators encoded by 'encode_wire' into 'rngs', which has room for
+   'capacity' of them, and sets 'n' to their number. Returns false, reading
+   nothing, if the bytes are not generators of type 'rng_t' in this format,
+   are truncated, or there are more than 'capacity' of them. */
+template <class rng_t>
+static inline bool decode_wire(const unsigned char *in, const std::size_t size,
+                               rng_t *rngs, const std::size_t capacity, std::size_t &n)
+{
+    WireHeader header;
+    if (!read_wire_header(in, size, header) || header.tag != rng_t::wire_tag || header.count > capacity
+        || (size - WIRE_HEADER_BYTES)/rng_t::state_bytes < header.count)
+        return false;
+    n = static_cast<std::size_t>(header.count);
+    load_pool(in + WIRE_HEADER_BYTES, n, rngs);
+    return true;
+}
+
+/* Random arrays written straight into memory from an arena, e.g. a
+   'std::pmr::memory_resource' or a 'BumpArena', with no other allocation:
+   'arena' is anything with 'void* allocate(std::size_t bytes, std::size_t
+   alignment)'. The arrays are aligned to 'FILL_ALIGNMENT' bytes, the width
+   of the widest vector registers the fills use, and are returned as
+   pointers to 'n' values (to be released by the arena), or as null pointers
+   if the arena returns null. */
+constexpr static const std::size_t FILL_ALIGNMENT = 64;
+
+/* Arena handing out consecutive pieces of a caller-provided buffer, which
+   are all released at once by 'reset'. 'allocate' returns a null pointer
+   when the buffer is exhausted. */
+class BumpArena
+{
+public:
+    BumpArena(void *buffer, const std::size_t size)
+        : begin(static_cast<unsigned char*>(buffer)), size(size) {}
+
+    void* allocate(const std::size_t bytes, const std::size_t alignment = FILL_ALIGNMENT)
+    {
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(this->begin);
+        const std::uintptr_t aligned = (base + this->used + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+        const std::size_t offset = static_cast<std::size_t>(aligned - base);
+        if (offset > this->size || this->size - offset < bytes)
+            return nullptr;
+        this->used = offset + bytes;
+        return this->begin + offset;
+    }
+
+    void reset()
+    {
+        this->used = 0;
+    }
+
+    std::size_t bytes_used() const
+    {
+        return this->used;
+    }
+
+private:
+    unsigned char *begin;
+    std::size_t size;
+    std::size_t used = 0;
+};
+
+template <class T, class arena_t>
+static inline T* arena_array(arena_t &arena, const std::size_t n)
+{
+    return static_cast<T*>(arena.allocate(n*sizeof(T), FILL_ALIGNMENT));
+}
+
+/* Raw outputs of 'rng' (a scalar engine or a 'XoshiroLanes'). */
+template <class rng_t, class arena_t>
+static inline typename rng_t::result_type* arena_ints(rng_t &rng, arena_t &arena, const std::size_t n)
+{
+    typename rng_t::result_type *out = arena_array<typename rng_t::result_type>(arena, n);
+    if (out) rng.fill(out, n);
+    return out;
+}
+
+/* 'fill_double' or 'fill_float', chosen by the type of 'out'. */
+template <class rng_t>
+static inline void fill_uniform_real(rng_t &rng, double *out, const std::size_t n)
+{
+    rng.fill_double(out, n);
+}
+
+template <class rng_t>
+static inline void fill_uniform_real(rng_t &rng, float *out, const std::size_t n)
+{
+    rng.fill_float(out, n);
+}
+
+/* Uniform 'float' or 'double' values in [0, 1), as from 'fill_float' / 'fill_double'. */
+template <class real_t, class rng_t, class arena_t>
+static inline real_t* arena_uniform(rng_t &rng, arena_t &arena, const std::size_t n)
+{
+    real_t *out = arena_array<real_t>(arena, n);
+    if (out) fill_uniform_real(rng, out, n);
+    return out;
+}
+
+/* Normal variates, as from 'fill_normal'. */
+template <class real_t, class rng_t, class arena_t>
+static inline real_t* arena_normal(rng_t &rng, arena_t &arena, const std::size_t n,
+                                   const double mean = 0, const double stddev = 1)
+{
+    real_t *out = arena_array<real_t>(arena, n);
+    if (out) fill_normal(rng, out, n, mean, stddev);
+    return out;
+}
+
+/* 'n_words' words of Bernoulli bitmasks, as from 'fill_bernoulli'. */
+template <class rng_t, class arena_t>
+static inline std::uint64_t* arena_bernoulli(rng_t &rng, arena_t &arena, const std::size_t n_words, const double p)
+{
+    std::uint64_t *out = arena_array<std::uint64_t>(arena, n_words);
+    if (out) fill_bernoulli(rng, out, n_words, p);
+    return out;
+}
+
+/* Outputs filled by each task of 'ParallelFill'. */
+constexpr static const std::size_t FILL_PARALLEL_CHUNK = std::size_t(1) << 18;
+
+/* Splits 'rng.fill(out, n)' into tasks filling 'FILL_PARALLEL_CHUNK' outputs
+   each, which can run in any order and on any threads: task 'i' starts from
+   'rng' jumped ahead by 'i * FILL_PARALLEL_CHUNK' steps (as given by a
+   'SubstreamLadder'), so every element gets the same value as with the serial
+   'fill', however the tasks are scheduled. Run 'task(i)' for every 'i' in
+   [0, n_tasks()) with any executor, e.g. an OpenMP loop or 'std::for_each'
+   with an execution policy, then continue from 'end()'. */
+template <class rng_t>
+class ParallelFill
+{
+public:
+    using result_type = typename rng_t::result_type;
+
+    ParallelFill(const rng_t &rng, result_type *out, const std::size_t n)
+        : ladder(rng, rng_t::jump_polynomial(FILL_PARALLEL_CHUNK)), out(out), n(n) {}
+
+    std::size_t n_tasks() const
+    {
+        return (this->n + FILL_PARALLEL_CHUNK - 1) / FILL_PARALLEL_CHUNK;
+    }
+
+    void operator()(const std::size_t task) const
+    {
+        const std::size_t start = task * FILL_PARALLEL_CHUNK;
+        const std::size_t n_chunk = (this->n - start < FILL_PARALLEL_CHUNK)? (this->n - start) : FILL_PARALLEL_CHUNK;
+        rng_t gen = this->ladder(task);
+        gen.fill(this->out + start, n_chunk);
+    }
+
+    /* The generator after the 'n' outputs, as left by the serial 'fill'. */
+    rng_t end() const
+    {
+        rng_t gen = this->ladder(this->n / FILL_PARALLEL_CHUNK);
+        gen.discard(this->n % FILL_PARALLEL_CHUNK);
+        return gen;
+    }
+
+private:
+    SubstreamLadder<rng_t> ladder;
+    result_type *out;
+    std::size_t n;
+};
+
+/* Same as 'rng.fill(out, n)', on 'n_threads' threads (zero meaning one per
+   hardware thread). */
+template <class rng_t>
+static inline void fill_parallel(rng_t &rng, typename rng_t::result_type *out, const std::size_t n,
+                                 const unsigned n_threads = 0)
+{
+    const ParallelFill<rng_t> tasks(rng, out, n);
+    run_tasks(tasks.n_tasks(), n_threads, tasks);
+    rng = tasks.end();
+}
+
+/* NUMA topology for 'NumaStreamPool'. Compiling with 'XOSHIRO_NUMA' defined
+   (and linking with libnuma) queries it from the system; otherwise a single
+   node is assumed. */
+static inline unsigned numa_node_count()
+{
+#if defined(XOSHIRO_NUMA)
+    if (numa_available() >= 0)
+        return static_cast<unsigned>(numa_num_configured_nodes());
+#endif
+    return 1;
+}
+
+/* The node of the CPU running the calling thread. */
+static inline unsigned current_numa_node()
+{
+#if defined(XOSHIRO_NUMA)
+    if (numa_available() >= 0)
+    {
+        const int cpu = sched_getcpu();
+        const int node = (cpu >= 0)? numa_node_of_cpu(cpu) : 0;
+        return (node >= 0)? static_cast<unsigned>(node) : 0;
+    }
+#endif
+    return 0;
+}
+
+/* Size of the pages that 'NodeArray' allocates. */
+static inline std::size_t page_size()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    const long size = sysconf(_SC_PAGESIZE);
+    if (size > 0) return static_cast<std::size_t>(size);
+#endif
+    return 4096;
+}
+
+/* Fixed-size array of 'n' cache-aligned 'value_t' in whole pages of its own,
+   so that it ends up on NUMA node 'node': allocated there by libnuma when
+   compiling with 'XOSHIRO_NUMA' (and the node exists), and otherwise
+   page-aligned, so that the first-touch policy places it on the node of the
+   thread constructing the elements (a block from the heap can share a page
+   with memory already touched on another node). The elements are
+   constructed with 'make(ix)'. */
+template <class value_t>
+class NodeArray
+{
+public:
+    using element_type = CacheAligned<value_t>;
+
+    template <class Make>
+    NodeArray(const std::size_t n, const unsigned node, Make make)
+    {
+        const std::size_t page = page_size();
+        if (n > (SIZE_MAX - 2*page) / sizeof(element_type))
+            throw std::bad_array_new_length();
+        this->bytes = (n*sizeof(element_type) + page - 1) / page * page;
+        #if defined(XOSHIRO_NUMA)
+        if (numa_available() >= 0 && static_cast<int>(node) <= numa_max_node())
+        {
+            this->raw = numa_alloc_onnode(this->bytes, static_cast<int>(node));
+            if (!this->raw) throw std::bad_alloc();
+            this->ptr = static_cast<element_type*>(this->raw);
+            this->from_numa = true;
+        }
+        #endif
+        if (!this->raw)
+        {
+            (void)node;
+            this->raw = ::operator new(this->bytes + page);
+            const std::size_t offset = reinterpret_cast<std::uintptr_t>(this->raw) % page;
+            this->ptr = reinterpret_cast<element_type*>(static_cast<char*>(this->raw) + (offset? page - offset : 0));
+        }
+        for (; this->n < n; this->n++)
+            new (this->ptr + this->n) element_type{make(this->n)};
+    }
+
+    ~NodeArray() noexcept
+    {
+        for (std::size_t ix = 0; ix < this->n; ix++)
+            this->ptr[ix].~element_type();
+        #if defined(XOSHIRO_NUMA)
+        if (this->from_numa)
+        {
+            numa_free(this->raw, this->bytes);
+            return;
+        }
+        #endif
+        ::operator delete(this->raw);
+    }
+
+    NodeArray(const NodeArray &other) = delete;
+
+    NodeArray& operator=(const NodeArray &other) = delete;
+
+    value_t& operator[](const std::size_t ix)
+    {
+        return this->ptr[ix].rng;
+    }
+
+    std::size_t size() const
+    {
+        return this->n;
+    }
+
+private:
+    void *raw = nullptr;
+    element_type *ptr = nullptr;
+    std::size_t bytes = 0;
+    std::size_t n = 0;
+    bool from_numa = false;
+};
+
+/* Pool of generators for threads spread over NUMA nodes, with
+   'streams_per_node' slots per node. Slot 'slot' of node 'node' holds stream
+   'node*streams_per_node + slot' of 'make_streams(base, ...)', so the streams
+   a thread gets depend on the node it runs on and not on the order in which
+   threads arrive. The streams of a node are made with 'make_streams' the
+   first time a thread asks for one of them, in a 'NodeArray' for that node.
+   'value_t' can be 'Buffered<rng_t, N>', to have the blocks of outputs on
+   the same node as well.
+
+   Threads should be pinned to their node (otherwise 'local' just goes by the
+   node they happen to be running on), and each slot used by one thread.
+   Without libnuma, give the number of nodes to the constructor to use more
+   than one with 'on_node'. */
+template <class rng_t, class value_t = rng_t>
+class NumaStreamPool
+{
+public:
+    NumaStreamPool(const rng_t &base, const std::size_t streams_per_node, const unsigned n_nodes = numa_node_count())
+        : base(base), per_node(streams_per_node), n_nodes(n_nodes? n_nodes : 1),
+          nodes(new std::atomic<NodeArray<value_t>*>[this->n_nodes])
+    {
+        for (unsigned node = 0; node < this->n_nodes; node++)
+            this->nodes[node].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~NumaStreamPool()
+    {
+        for (unsigned node = 0; node < this->n_nodes; node++)
+            delete this->nodes[node].load(std::memory_order_relaxed);
+        delete[] this->nodes;
+    }
+
+    NumaStreamPool(const NumaStreamPool &other) = delete;
+
+    NumaStreamPool& operator=(const NumaStreamPool &other) = delete;
+
+    /* Slot 'slot' of the node the calling thread runs on. */
+    value_t& local(const std::size_t slot)
+    {
+        return this->on_node(current_numa_node() % this->n_nodes, slot);
+    }
+
+    /* Throws 'std::out_of_range' unless 'node < node_count()' and
+       'slot < streams_per_node()'. */
+    value_t& on_node(const unsigned node, const std::size_t slot)
+    {
+        if (node >= this->n_nodes || slot >= this->per_node)
+            throw std::out_of_range("NumaStreamPool: no such node or slot");
+        NodeArray<value_t> *streams = this->nodes[node].load(std::memory_order_acquire);
+        if (!streams)
+        {
+            NodeArray<value_t> *made = this->make_node(node);
+            if (this->nodes[node].compare_exchange_strong(streams, made, std::memory_order_acq_rel))
+                streams = made;
+            else
+                delete made;
+        }
+        return (*streams)[slot];
+    }
+
+    unsigned node_count() const
+    {
+        return this->n_nodes;
+    }
+
+    std::size_t streams_per_node() const
+    {
+        return this->per_node;
+    }
+
+private:
+    NodeArray<value_t>* make_node(const unsigned node) const
+    {
+        const StreamArray<rng_t> streams = make_streams(nth_stream(this->base, node*this->per_node), this->per_node);
+        return new NodeArray<value_t>(this->per_node, node,
+                                      [&streams](const std::size_t ix) { return value_t(streams[ix]); });
+    }
+
+    rng_t base;
+    std::size_t per_node;
+    unsigned n_nodes;
+    std::atomic<NodeArray<value_t>*> *nodes;
+};
+
+/* Outputs of 'rng_t' produced ahead of time by a background thread, in blocks
+   of 'N' values passed to the consumer through a lock-free single-producer,
+   single-consumer ring of 'n_blocks' blocks. The consumer sees exactly the
+   sequence of the engine ('fill' of one block after another). The producer
+   stays at most 'n_blocks' blocks ahead and, while the ring is full, waits
+   'idle_wait' between checks (zero meaning to just yield). All the consumer
+   functions must be called from one thread at a time, which is also where
+   coroutines waiting for blocks are resumed. */
+template <class rng_t, std::size_t N = 4096>
+class AsyncStream
+{
+public:
+    using result_type = typename rng_t::result_type;
+
+    constexpr static result_type min()
+    {
+        return rng_t::min();
+    }
+
+    constexpr static result_type max()
+    {
+        return rng_t::max();
+    }
 
-namespace Xoshiro {
+    explicit AsyncStream(const rng_t &rng, const std::size_t n_blocks = 8,
+                         const std::chrono::nanoseconds idle_wait = std::chrono::nanoseconds(0))
+        : n_blocks(n_blocks? n_blocks : 1), idle_wait(idle_wait), blocks(this->n_blocks * N)
+    {
+        this->producer = std::thread([this, rng]() { this->produce(rng); });
+    }
 
+    ~AsyncStream()
+    {
+        this->stop.store(true, std::memory_order_relaxed);
+        this->producer.join();
+    }
 
-#if __cplusplus >= 202001L
-#   define HAS_CPP20
-#endif
+    AsyncStream(const AsyncStream &other) = delete;
 
-static inline std::uint64_t rotl64(const std::uint64_t x, const int k) {
-    return (x << k) | (x >> (64 - k));
-}
+    AsyncStream& operator=(const AsyncStream &other) = delete;
 
-static inline std::uint32_t rotl32(const std::uint32_t x, const int k) {
-    return (x << k) | (x >> (32 - k));
-}
+    /* Releases the block returned by the previous call, so that the producer
+       can refill it (with a single block, this is what lets it go on), and
+       returns the next one ('N' values), or a null pointer if it is not ready
+       yet. The block 'operator()' was reading from counts as the previous
+       one: the rest of it is skipped. */
+    const result_type* try_next_block()
+    {
+        this->release();
+        if (this->tail.load(std::memory_order_acquire) == this->head)
+            return nullptr;
+        this->holding = true;
+        return this->blocks.data() + (this->head % this->n_blocks) * N;
+    }
 
-/* these are in order to avoid gcc warnings about 'strict aliasing rules' */
-static inline std::uint32_t extract_32bits_from64_left(const std::uint64_t x)
-{
-    std::uint32_t out;
-    std::memcpy(&out, reinterpret_cast<const std::uint32_t*>(&x), sizeof(std::uint32_t));
-    return out;
-}
+    /* Same, waiting for the block to be ready. */
+    const result_type* next_block()
+    {
+        const result_type *block;
+        while (!(block = this->try_next_block()))
+            std::this_thread::yield();
+        return block;
+    }
 
-static inline std::uint32_t extract_32bits_from64_right(const std::uint64_t x)
-{
-    std::uint32_t out;
-    std::memcpy(&out, reinterpret_cast<const std::uint32_t*>(&x) + 1, sizeof(std::uint32_t));
-    return out;
-}
+    /* One value at a time, taking blocks as needed (the next call to
+       'try_next_block' or 'next_block' skips the rest of the current one). */
+    result_type operator()()
+    {
+        if (this->pos == N)
+        {
+            this->current = this->next_block();
+            this->pos = 0;
+        }
+        return this->current[this->pos++];
+    }
 
-static inline void assign_32bits_to64_left(std::uint64_t assign_to, const std::uint32_t take_from)
-{
-    std::memcpy(reinterpret_cast<std::uint32_t*>(&assign_to), &take_from, sizeof(std::uint32_t));
-}
+    #ifdef XOSHIRO_HAS_COROUTINES
+    /* 'co_await stream.next_block_async()' gives the next block as
+       'next_block' does, suspending the coroutine if it is not ready yet.
+       The producer never runs consumer code: a suspended coroutine is
+       resumed by the consumer thread calling 'resume_waiting()' (e.g. from
+       its event loop). One coroutine may be waiting at a time. */
+    struct BlockAwaiter
+    {
+        AsyncStream &stream;
+        const result_type *block = nullptr;
+        std::coroutine_handle<> handle = nullptr;
 
-static inline void assign_32bits_to64_right(std::uint64_t assign_to, const std::uint32_t take_from)
-{
-    std::memcpy(reinterpret_cast<std::uint32_t*>(&assign_to) + 1, &take_from, sizeof(std::uint32_t));
-}
+        bool await_ready()
+        {
+            return (this->block = this->stream.try_next_block()) != nullptr;
+        }
 
-constexpr static const uint64_t JUMP_X256PP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            this->handle = handle;
+            this->stream.waiting = this;
+        }
 
-constexpr static const uint64_t LONG_JUMP_X256PP[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
+        const result_type* await_resume()
+        {
+            return this->block;
+        }
+    };
 
-constexpr static const uint32_t JUMP_X128PP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    BlockAwaiter next_block_async()
+    {
+        return BlockAwaiter{*this};
+    }
 
-constexpr static const uint32_t LONG_JUMP_X128PP[] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+    /* Resumes the coroutine suspended in 'next_block_async', on the calling
+       thread, if its block is ready. Returns whether it did. */
+    bool resume_waiting()
+    {
+        BlockAwaiter *awaiter = this->waiting;
+        if (!awaiter || !(awaiter->block = this->try_next_block()))
+            return false;
+        this->waiting = nullptr;
+        awaiter->handle.resume();
+        return true;
+    }
+    #endif
 
-template <class int_t, class rng_t>
-static inline void jump_state(const int_t jump_table[4], rng_t &rng)
-{
-    int_t s0 = 0;
-    int_t s1 = 0;
-    int_t s2 = 0;
-    int_t s3 = 0;
-    for (int i = 0; i < 4; i++)
+private:
+    void release()
     {
-        for (int b = 0; b < 8*static_cast<int>(sizeof(int_t)); b++)
+        if (!this->holding) return;
+        this->holding = false;
+        this->current = nullptr;
+        this->pos = N;
+        this->head_released.store(++this->head, std::memory_order_release);
+    }
+
+    void produce(rng_t rng)
+    {
+        for (std::size_t ix = 0; !this->stop.load(std::memory_order_relaxed); )
         {
-            if (jump_table[i] & ((int_t)1) << b)
+            if (ix - this->head_released.load(std::memory_order_acquire) >= this->n_blocks)
             {
-                s0 ^= rng.state[0];
-                s1 ^= rng.state[1];
-                s2 ^= rng.state[2];
-                s3 ^= rng.state[3];
+                if (this->idle_wait.count() > 0)
+                    std::this_thread::sleep_for(this->idle_wait);
+                else
+                    std::this_thread::yield();
+                continue;
             }
-            rng();
+            rng.fill(this->blocks.data() + (ix % this->n_blocks) * N, N);
+            this->tail.store(++ix, std::memory_order_release);
         }
     }
 
-    rng.state[0] = s0;
-    rng.state[1] = s1;
-    rng.state[2] = s2;
-    rng.state[3] = s3;
-}
+    const std::size_t n_blocks;
+    const std::chrono::nanoseconds idle_wait;
+    std::vector<result_type> blocks;
+    std::thread producer;
+    std::atomic<bool> stop{false};
+    /* Blocks published by the producer, and the oldest one still in use by the consumer. */
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_released{0};
+    /* Consumer side. */
+    alignas(CACHE_LINE_SIZE) std::size_t head = 0;
+    bool holding = false;
+    const result_type *current = nullptr;
+    std::size_t pos = N;
+    #ifdef XOSHIRO_HAS_COROUTINES
+    BlockAwaiter *waiting = nullptr;
+    #endif
+};
 
-/* This is a fixed-increment version of Java 8's SplittableRandom generator
-   See http://dx.doi.org/10.1145/2714064.2660195 and
-   http://docs.oracle.com/javase/8/docs/api/java/util/SplittableRandom.html
+/* Draw counters, for seeing how many values each part of a program takes and
+   how far its streams get. 'position' is the number of steps since the last
+   seed, and 'stream_usage' below relates it to the distance between streams
+   made by 'jump()'. In a registry entry the counts are summed over the
+   instances and 'position' is the largest of them. */
+struct DrawStats
+{
+    std::uint64_t draws = 0;
+    std::uint64_t discarded = 0;
+    std::uint64_t jumps = 0;
+    std::uint64_t reseeds = 0;
+    std::uint64_t position = 0;
+};
 
-   It is a very fast generator passing BigCrush, and it can be useful if
-   for some reason you absolutely want 64 bits of state. */
-static inline std::uint64_t splitmix64(const std::uint64_t seed)
+/* Counters of all the instrumented engines registered under one name. */
+struct StatsEntry
 {
-    std::uint64_t z = (seed + 0x9e3779b97f4a7c15);
-    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
-    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
-    return z ^ (z >> 31);
-}
+    explicit StatsEntry(const char *name) : name(name) {}
 
-/* This is xoshiro256++ 1.0, one of our all-purpose, rock-solid generators.
-   It has excellent (sub-ns) speed, a state (256 bits) that is large
-   enough for any parallel application, and it passes all tests we are
-   aware of.
+    const std::string name;
+    std::atomic<std::uint64_t> draws{0};
+    std::atomic<std::uint64_t> discarded{0};
+    std::atomic<std::uint64_t> jumps{0};
+    std::atomic<std::uint64_t> reseeds{0};
+    std::atomic<std::uint64_t> max_position{0};
+    StatsEntry *next = nullptr;
+};
+
+/* Process-wide list of 'StatsEntry', which are added without locks and live
+   until the end of the program. */
+class StatsRegistry
+{
+public:
+    static StatsEntry* entry(const char *name)
+    {
+        std::atomic<StatsEntry*> &head = StatsRegistry::head();
+        StatsEntry *first = head.load(std::memory_order_acquire);
+        StatsEntry *created = nullptr;
+        for (;;)
+        {
+            for (StatsEntry *found = first; found; found = found->next)
+            {
+                if (found->name == name)
+                {
+                    delete created;
+                    return found;
+                }
+            }
+            if (!created) created = new StatsEntry(name);
+            created->next = first;
+            if (head.compare_exchange_weak(first, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                return created;
+        }
+    }
+
+    /* The counts flushed so far, by name. */
+    static std::vector<std::pair<std::string, DrawStats>> snapshot()
+    {
+        std::vector<std::pair<std::string, DrawStats>> out;
+        for (StatsEntry *entry = head().load(std::memory_order_acquire); entry; entry = entry->next)
+        {
+            DrawStats stats;
+            stats.draws = entry->draws.load(std::memory_order_relaxed);
+            stats.discarded = entry->discarded.load(std::memory_order_relaxed);
+            stats.jumps = entry->jumps.load(std::memory_order_relaxed);
+            stats.reseeds = entry->reseeds.load(std::memory_order_relaxed);
+            stats.position = entry->max_position.load(std::memory_order_relaxed);
+            out.emplace_back(entry->name, stats);
+        }
+        return out;
+    }
+
+private:
+    static std::atomic<StatsEntry*>& head()
+    {
+        static std::atomic<StatsEntry*> first{nullptr};
+        return first;
+    }
+};
 
-   For generating just floating-point numbers, xoshiro256+ is even faster.
+/* Number of draws after which an instance adds its counts to its registry entry. */
+constexpr static const std::uint64_t STATS_FLUSH_DRAWS = std::uint64_t(1) << 20;
 
-   The state must be seeded so that it is not everywhere zero. If you have
-   a 64-bit seed, we suggest to seed a splitmix64 generator and use its
-   output to fill s. */
-class Xoshiro256PP
+/* Instrumentation policies of 'Instrumented': 'NoStats' does nothing and
+   takes no space, 'CountingStats' keeps a 'DrawStats' per instance and adds
+   it to the registry entry of its name every STATS_FLUSH_DRAWS draws, on
+   'flush()' and on destruction. A copy (or a jumped generator) starts from
+   the counts of the original but only adds to the registry what it draws
+   itself. */
+class NoStats
 {
 public:
-    using result_type = std::uint64_t;
-    std::uint64_t state[4] = {0x3d23dce41c588f8c, 0x10c770bb8da027b0, 0xc7a4c5e87c63ba25, 0xa830f83239465a2e};
+    explicit NoStats(const char * = nullptr) {}
 
-    constexpr static result_type min()
+    void count_draws(const std::size_t) {}
+
+    void count_discard(const unsigned long long) {}
+
+    void count_reseed() {}
+
+    NoStats next_stream() const
     {
-        return 0;
+        return *this;
     }
 
-    constexpr static result_type max()
+    DrawStats stats() const
     {
-        return UINT64_MAX;
+        return DrawStats();
     }
 
-    Xoshiro256PP() = default;
+    void flush() {}
+};
 
-    ~Xoshiro256PP() noexcept = default;
+class CountingStats
+{
+public:
+    explicit CountingStats(const char *name = "default") : entry(StatsRegistry::entry(name)) {}
 
-    Xoshiro256PP(Xoshiro256PP &other) = default;
+    CountingStats(const CountingStats &other) : entry(other.entry), local(other.local), flushed(other.local) {}
 
-    Xoshiro256PP& operator=(const Xoshiro256PP &other) = default;
+    CountingStats& operator=(const CountingStats &other)
+    {
+        if (this != &other)
+        {
+            this->flush();
+            this->entry = other.entry;
+            this->local = other.local;
+            this->flushed = other.local;
+        }
+        return *this;
+    }
 
-    Xoshiro256PP(Xoshiro256PP &&) noexcept = default;
+    ~CountingStats()
+    {
+        this->flush();
+    }
 
-    Xoshiro256PP& operator=(Xoshiro256PP &&) noexcept = default;
+    void count_draws(const std::size_t n)
+    {
+        this->local.draws += n;
+        this->local.position += n;
+        if (this->local.draws - this->flushed.draws >= STATS_FLUSH_DRAWS)
+            this->flush();
+    }
 
-    void seed(const std::uint64_t seed)
+    void count_discard(const unsigned long long z)
     {
-        this->state[0] = splitmix64(splitmix64(seed));
-        this->state[1] = splitmix64(this->state[0]);
-        this->state[2] = splitmix64(this->state[1]);
-        this->state[3] = splitmix64(this->state[2]);
+        this->local.discarded += z;
+        this->local.position += z;
     }
 
-    void seed(const std::uint64_t seed[4])
+    void count_reseed()
     {
-        std::memcpy(this->state, seed, 4*sizeof(std::uint64_t));
+        this->local.reseeds++;
+        this->local.position = 0;
     }
 
-    template<class Sseq>
-    void seed(Sseq& seq)
+    /* Counters of a generator jumped from this one: same position in the next stream. */
+    CountingStats next_stream() const
     {
-        seq.generate(reinterpret_cast<std::uint32_t*>(&this->state[0]),
-                     reinterpret_cast<std::uint32_t*>(&this->state[0] + 4));
+        CountingStats out(*this);
+        out.local.jumps++;
+        return out;
     }
 
-    explicit Xoshiro256PP(const std::uint64_t seed)
+    DrawStats stats() const
     {
-        this->seed(seed);
+        return this->local;
     }
 
-    explicit Xoshiro256PP(const std::uint64_t seed[4])
+    void flush()
     {
-        this->seed(seed);
+        this->entry->draws.fetch_add(this->local.draws - this->flushed.draws, std::memory_order_relaxed);
+        this->entry->discarded.fetch_add(this->local.discarded - this->flushed.discarded, std::memory_order_relaxed);
+        this->entry->jumps.fetch_add(this->local.jumps - this->flushed.jumps, std::memory_order_relaxed);
+        this->entry->reseeds.fetch_add(this->local.reseeds - this->flushed.reseeds, std::memory_order_relaxed);
+        std::uint64_t max_position = this->entry->max_position.load(std::memory_order_relaxed);
+        while (max_position < this->local.position
+               && !this->entry->max_position.compare_exchange_weak(max_position, this->local.position, std::memory_order_relaxed))
+        {}
+        this->flushed = this->local;
     }
 
-    template<class Sseq>
-    explicit Xoshiro256PP(Sseq& seq)
+private:
+    StatsEntry *entry;
+    DrawStats local;
+    DrawStats flushed;
+};
+
+/* The policy of 'Instrumented' when none is given: counting when compiling
+   with -DXOSHIRO_STATS, nothing otherwise. */
+#if defined(XOSHIRO_STATS)
+using DefaultStats = CountingStats;
+#else
+using DefaultStats = NoStats;
+#endif
+
+/* Adaptor that produces the same sequence as 'rng_t' and reports its use
+   through the policy 'Stats', under the name given at construction. With
+   'NoStats' it compiles down to the bare engine. */
+template <class rng_t, class Stats = DefaultStats>
+class Instrumented : private Stats
+{
+public:
+    using result_type = typename rng_t::result_type;
+    using engine_type = rng_t;
+
+    constexpr static result_type min()
     {
-        this->seed(seq);
+        return rng_t::min();
+    }
+
+    constexpr static result_type max()
+    {
+        return rng_t::max();
+    }
+
+    explicit Instrumented(const rng_t &engine = rng_t(), const char *name = "default")
+        : Stats(name), engine(engine)
+    {}
+
+    explicit Instrumented(const std::uint64_t seed, const char *name = "default")
+        : Stats(name), engine(seed)
+    {}
+
+    void seed(const std::uint64_t seed)
+    {
+        this->engine.seed(seed);
+        this->count_reseed();
+    }
+
+    void seed(const rng_t &engine)
+    {
+        this->engine = engine;
+        this->count_reseed();
     }
 
     result_type operator()()
     {
-        const std::uint64_t result = rotl64(this->state[0] + this->state[3], 23) + this->state[0];
-        const std::uint64_t t = this->state[1] << 17;
-        this->state[2] ^= this->state[0];
-        this->state[3] ^= this->state[1];
-        this->state[1] ^= this->state[2];
-        this->state[0] ^= this->state[3];
-        this->state[2] ^= t;
-        this->state[3] = rotl64(this->state[3], 45);
-        return result;
+        this->count_draws(1);
+        return this->engine();
+    }
+
+    void fill(result_type *out, const std::size_t n)
+    {
+        this->count_draws(n);
+        this->engine.fill(out, n);
     }
 
     void discard(unsigned long long z)
     {
-        for (unsigned long long ix = 0; ix < z; ix++)
-            this->operator()();
+        this->count_discard(z);
+        this->engine.discard(z);
     }
 
-    Xoshiro256PP jump()
+    Instrumented jump() const
     {
-        Xoshiro256PP new_gen = *this;
-        jump_state(JUMP_X256PP, new_gen);
-        return new_gen;
+        return Instrumented(this->engine.jump(), this->next_stream());
     }
 
-    Xoshiro256PP long_jump()
+    Instrumented long_jump() const
     {
-        Xoshiro256PP new_gen = *this;
-        jump_state(LONG_JUMP_X256PP, new_gen);
-        return new_gen;
+        return Instrumented(this->engine.long_jump(), this->next_stream());
     }
 
-    bool operator==(const Xoshiro256PP &rhs)
+    const rng_t& base() const
     {
-        return std::memcmp(this->state, rhs.state, 4*sizeof(std::uint64_t));
+        return this->engine;
     }
 
-    #ifndef HAS_CPP20
-    bool operator!=(const Xoshiro256PP &rhs)
+    DrawStats stats() const
     {
-        return !std::memcmp(this->state, rhs.state, 4*sizeof(std::uint64_t));
+        return this->Stats::stats();
     }
-    #endif
 
-    template< class CharT, class Traits >
-    friend std::basic_ostream<CharT,Traits>&
-    operator<<(std::basic_ostream<CharT,Traits>& ost, const Xoshiro256PP& e)
+    /* Fraction of the distance to the stream made by 'jump()' (2^(bits/2),
+       bits being the size of the state) used since the last seed. */
+    double stream_usage() const
     {
-        ost.write(reinterpret_cast<const char*>(&e.state[0]), sizeof(std::uint64_t));
-        ost.put(' ');
-        ost.write(reinterpret_cast<const char*>(&e.state[1]), sizeof(std::uint64_t));
-        ost.put(' ');
-        ost.write(reinterpret_cast<const char*>(&e.state[2]), sizeof(std::uint64_t));
-        ost.put(' ');
-        ost.write(reinterpret_cast<const char*>(&e.state[3]), sizeof(std::uint64_t));
-        return ost;
+        constexpr int jump_log2 = rng_t::state_words * 8 * static_cast<int>(sizeof(result_type)) / 2;
+        return std::ldexp(static_cast<double>(this->stats().position), -jump_log2);
     }
-    template< class CharT, class Traits >
-    friend std::basic_istream<CharT,Traits>&
-    operator>>(std::basic_istream<CharT,Traits>& ist, Xoshiro256PP& e)
+
+    using Stats::flush;
+
+    bool operator==(const Instrumented &other) const
     {
-        ist.read(reinterpret_cast<char*>(&e.state[0]), sizeof(std::uint64_t));
-        ist.get();
-        ist.read(reinterpret_cast<char*>(&e.state[1]), sizeof(std::uint64_t));
-        ist.get();
-        ist.read(reinterpret_cast<char*>(&e.state[2]), sizeof(std::uint64_t));
-        ist.get();
-        ist.read(reinterpret_cast<char*>(&e.state[3]), sizeof(std::uint64_t));
-        return ist;
+        return this->engine == other.engine;
     }
-};
 
-/* This is xoshiro128++ 1.0, one of our 32-bit all-purpose, rock-solid
-   generators. It has excellent speed, a state size (128 bits) that is
-   large enough for mild parallelism, and it passes all tests we are aware
-   of.
+    bool operator!=(const Instrumented &other) const
+    {
+        return this->engine != other.engine;
+    }
 
-   For generating just single-precision (i.e., 32-bit) floating-point
-   numbers, xoshiro128+ is even faster.
+private:
+    Instrumented(const rng_t &engine, const Stats &stats) : Stats(stats), engine(engine) {}
 
-   The state must be seeded so that it is not everywhere zero. */
-class Xoshiro128PP
-{
-public:
-    using result_type = std::uint32_t;
-    std::uint32_t state[4] = {0x1c588f8c, 0x3d23dce4, 0x8da027b0, 0x10c770bb};
+    rng_t engine;
+};
 
-    constexpr static result_type min()
+/* Fills 'out' with 'n' bytes from the entropy source of the operating
+   system: getrandom on Linux, arc4random_buf on macOS and the BSDs, and
+   'std::random_device' elsewhere (or when getrandom is not available). */
+struct OsEntropy
+{
+    void operator()(unsigned char *out, std::size_t n) const
     {
-        return 0;
+        #if defined(XOSHIRO_HAS_GETRANDOM)
+        while (n > 0)
+        {
+            const ssize_t got = getrandom(out, n, 0);
+            if (got < 0)
+            {
+                if (errno == EINTR) continue;
+                break;
+            }
+            out += got;
+            n -= static_cast<std::size_t>(got);
+        }
+        #elif defined(XOSHIRO_HAS_ARC4RANDOM)
+        arc4random_buf(out, n);
+        n = 0;
+        #endif
+        if (n > 0)
+        {
+            std::random_device device;
+            for (; n > 0; out++, n--)
+                *out = static_cast<unsigned char>(device());
+        }
     }
+};
 
-    constexpr static result_type max()
+/* Bytes of entropy read at once by 'reseed_pool'. */
+constexpr static const std::size_t ENTROPY_BLOCK_BYTES = 4096;
+
+/* Sets the states of the 'n' generators at 'rngs' to fresh bytes from
+   'entropy' (anything called as 'entropy(out, n_bytes)'), so that they are
+   independent of each other and of their previous states. The bytes are
+   read in blocks of ENTROPY_BLOCK_BYTES for the whole pool, without
+   allocating; an all-zero state, which the generators cannot leave, is drawn
+   again. */
+template <class rng_t, class Entropy = OsEntropy>
+static inline void reseed_pool(rng_t *rngs, const std::size_t n, Entropy entropy = Entropy())
+{
+    constexpr std::size_t batch = (ENTROPY_BLOCK_BYTES / rng_t::state_bytes) > 0?
+                                  (ENTROPY_BLOCK_BYTES / rng_t::state_bytes) : 1;
+    unsigned char bytes[batch * rng_t::state_bytes];
+    for (std::size_t start = 0; start < n; start += batch)
     {
-        return UINT32_MAX;
+        const std::size_t n_batch = (n - start < batch)? (n - start) : batch;
+        entropy(bytes, n_batch * rng_t::state_bytes);
+        load_pool(bytes, n_batch, rngs + start);
+        for (std::size_t ix = start; ix < start + n_batch; ix++)
+        {
+            for (;;)
+            {
+                bool zero = true;
+                for (int w = 0; w < rng_t::state_words; w++)
+                    zero = zero && !rngs[ix].state[w];
+                if (!zero) break;
+                entropy(bytes, rng_t::state_bytes);
+                rngs[ix].load(bytes);
+            }
+        }
     }
+}
 
-    Xoshiro128PP() = default;
-
-    ~Xoshiro128PP() noexcept = default;
+template <class rng_t, class Entropy = OsEntropy>
+static inline void reseed(rng_t &rng, Entropy entropy = Entropy())
+{
+    reseed_pool(&rng, 1, entropy);
+}
 
-    Xoshiro128PP(Xoshiro128PP &other) = default;
+/* A position in the sequence of 'rng_t' recorded as a base state and the
+   number of steps taken from it, which 'restore' replays with 'discard' (in
+   logarithmic time). Two checkpoints with the same base differ only by their
+   'steps'. The stream format is the base, as written by the engine's
+   'operator<<', then ' ' and the steps as 8 bytes; the binary one of
+   'save'/'load' is the base as per the engine's 'save' then the steps in
+   little-endian order, 'checkpoint_bytes' in total. */
+template <class rng_t>
+struct DeltaCheckpoint
+{
+    constexpr static const std::size_t checkpoint_bytes = rng_t::state_bytes + sizeof(std::uint64_t);
 
-    Xoshiro128PP& operator=(const Xoshiro128PP &other) = default;
+    rng_t base;
+    std::uint64_t steps = 0;
 
-    Xoshiro128PP(Xoshiro128PP &&) noexcept = default;
+    rng_t restore() const
+    {
+        rng_t out = this->base;
+        out.discard(this->steps);
+        return out;
+    }
 
-    Xoshiro128PP& operator=(Xoshiro128PP &&) noexcept = default;
+    void save(unsigned char *out) const
+    {
+        this->base.save(out);
+        store_le(out + rng_t::state_bytes, &this->steps, 1);
+    }
 
-    void seed(const std::uint64_t seed)
+    void load(const unsigned char *in)
     {
-        const auto t1 = splitmix64(seed);
-        const auto t2 = splitmix64(t1);
-        this->state[0] = splitmix64(extract_32bits_from64_left(t1));
-        this->state[1] = splitmix64(extract_32bits_from64_right(t1));
-        this->state[2] = splitmix64(extract_32bits_from64_left(t2));
-        this->state[3] = splitmix64(extract_32bits_from64_right(t2));
+        this->base.load(in);
+        load_le(&this->steps, in + rng_t::state_bytes, 1);
     }
 
-    void seed(const std::uint32_t seed)
+    template< class CharT, class Traits >
+    friend std::basic_ostream<CharT,Traits>&
+    operator<<(std::basic_ostream<CharT,Traits>& ost, const DeltaCheckpoint& c)
     {
-        std::uint64_t temp;
-        assign_32bits_to64_left(temp, seed);
-        assign_32bits_to64_right(temp, seed);
-        this->seed(temp);
+        ost << c.base;
+        ost.put(' ');
+        ost.write(reinterpret_cast<const char*>(&c.steps), sizeof(std::uint64_t));
+        return ost;
+    }
+    template< class CharT, class Traits >
+    friend std::basic_istream<CharT,Traits>&
+    operator>>(std::basic_istream<CharT,Traits>& ist, DeltaCheckpoint& c)
+    {
+        ist >> c.base;
+        ist.get();
+        ist.read(reinterpret_cast<char*>(&c.steps), sizeof(std::uint64_t));
+        return ist;
     }
+};
 
-    void seed(const std::uint64_t seed[2])
+/* Adaptor that produces the same sequence as 'rng_t' and keeps track of its
+   position as a 'DeltaCheckpoint', from the last seed or 'rebase()'. Its
+   'operator<<' writes that checkpoint instead of the current state, and its
+   'operator>>' restores from one, so what is written stays the same base
+   with a growing count between rebases. */
+template <class rng_t>
+class Checkpointed
+{
+public:
+    using result_type = typename rng_t::result_type;
+    using engine_type = rng_t;
+
+    constexpr static result_type min()
     {
-        std::memcpy(this->state, seed, 4*sizeof(std::uint32_t));
+        return rng_t::min();
     }
 
-    void seed(const std::uint32_t seed[4])
+    constexpr static result_type max()
     {
-        std::memcpy(this->state, seed, 4*sizeof(std::uint32_t));
+        return rng_t::max();
     }
 
-    template<class Sseq>
-    void seed(Sseq& seq)
+    Checkpointed() = default;
+
+    explicit Checkpointed(const rng_t &engine) : engine(engine)
     {
-        seq.generate(&this->state[0], &this->state[0] + 4);
+        this->delta.base = engine;
     }
 
-    explicit Xoshiro128PP(const std::uint32_t seed)
+    explicit Checkpointed(const std::uint64_t seed) : Checkpointed(rng_t(seed)) {}
+
+    explicit Checkpointed(const DeltaCheckpoint<rng_t> &checkpoint) : engine(checkpoint.restore()), delta(checkpoint) {}
+
+    void seed(const std::uint64_t seed)
     {
-        this->seed(seed);
+        this->seed(rng_t(seed));
     }
 
-    explicit Xoshiro128PP(const std::uint64_t seed)
+    void seed(const rng_t &engine)
     {
-        this->seed(seed);
+        this->engine = engine;
+        this->delta.base = engine;
+        this->delta.steps = 0;
     }
 
-    explicit Xoshiro128PP(const std::uint32_t seed[4])
+    result_type operator()()
     {
-        this->seed(seed);
+        this->delta.steps++;
+        return this->engine();
     }
 
-    explicit Xoshiro128PP(const std::uint64_t seed[2])
+    void fill(result_type *out, const std::size_t n)
     {
-        this->seed(seed);
+        this->delta.steps += n;
+        this->engine.fill(out, n);
     }
 
-    template<class Sseq>
-    explicit Xoshiro128PP(Sseq& seq)
+    void discard(unsigned long long z)
     {
-        this->seed(seq);
+        this->delta.steps += z;
+        this->engine.discard(z);
     }
 
-    result_type operator()()
+    /* Makes the current state the base of the following checkpoints. */
+    void rebase()
     {
-        const std::uint32_t result = rotl32(this->state[0] + this->state[3], 7) + this->state[0];
-        const std::uint32_t t = this->state[1] << 9;
-        this->state[2] ^= this->state[0];
-        this->state[3] ^= this->state[1];
-        this->state[1] ^= this->state[2];
-        this->state[0] ^= this->state[3];
-        this->state[2] ^= t;
-        this->state[3] = rotl32(this->state[3], 11);
-        return result;
+        this->delta.base = this->engine;
+        this->delta.steps = 0;
     }
 
-    Xoshiro128PP jump()
+    const DeltaCheckpoint<rng_t>& checkpoint() const
     {
-        Xoshiro128PP new_gen = *this;
-        jump_state(JUMP_X128PP, new_gen);
-        return new_gen;
+        return this->delta;
     }
 
-    Xoshiro128PP long_jump()
+    void restore(const DeltaCheckpoint<rng_t> &checkpoint)
     {
-        Xoshiro128PP new_gen = *this;
-        jump_state(LONG_JUMP_X128PP, new_gen);
-        return new_gen;
+        this->delta = checkpoint;
+        this->engine = checkpoint.restore();
     }
 
-    void discard(unsigned long long z)
+    const rng_t& base() const
     {
-        for (unsigned long long ix = 0; ix < z; ix++)
-            this->operator()();
+        return this->engine;
     }
 
-    bool operator==(const Xoshiro128PP &rhs)
+    bool operator==(const Checkpointed &other) const
     {
-        return std::memcmp(this->state, rhs.state, 4*sizeof(std::uint32_t));
+        return this->engine == other.engine;
     }
 
-    #ifndef HAS_CPP20
-    bool operator!=(const Xoshiro128PP &rhs)
+    bool operator!=(const Checkpointed &other) const
     {
-        return !std::memcmp(this->state, rhs.state, 4*sizeof(std::uint32_t));
+        return this->engine != other.engine;
     }
-    #endif
 
     template< class CharT, class Traits >
     friend std::basic_ostream<CharT,Traits>&
-    operator<<(std::basic_ostream<CharT,Traits>& ost, const Xoshiro128PP& e)
+    operator<<(std::basic_ostream<CharT,Traits>& ost, const Checkpointed& e)
     {
-        ost.write(reinterpret_cast<const char*>(&e.state[0]), sizeof(std::uint32_t));
-        ost.put(' ');
-        ost.write(reinterpret_cast<const char*>(&e.state[1]), sizeof(std::uint32_t));
-        ost.put(' ');
-        ost.write(reinterpret_cast<const char*>(&e.state[2]), sizeof(std::uint32_t));
-        ost.put(' ');
-        ost.write(reinterpret_cast<const char*>(&e.state[3]), sizeof(std::uint32_t));
-        return ost;
+        return ost << e.delta;
     }
     template< class CharT, class Traits >
     friend std::basic_istream<CharT,Traits>&
-    operator>>(std::basic_istream<CharT,Traits>& ist, Xoshiro128PP& e)
+    operator>>(std::basic_istream<CharT,Traits>& ist, Checkpointed& e)
     {
-        ist.read(reinterpret_cast<char*>(&e.state[0]), sizeof(std::uint32_t));
-        ist.get();
-        ist.read(reinterpret_cast<char*>(&e.state[1]), sizeof(std::uint32_t));
-        ist.get();
-        ist.read(reinterpret_cast<char*>(&e.state[2]), sizeof(std::uint32_t));
-        ist.get();
-        ist.read(reinterpret_cast<char*>(&e.state[3]), sizeof(std::uint32_t));
+        DeltaCheckpoint<rng_t> checkpoint;
+        if (ist >> checkpoint)
+            e.restore(checkpoint);
         return ist;
     }
+
+private:
+    rng_t engine;
+    DeltaCheckpoint<rng_t> delta;
 };
 
 }